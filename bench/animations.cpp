@@ -0,0 +1,96 @@
+/**
+ * Benchmark of animation loading: TexturePacker json parsing against the
+ * precompiled binary table of the same atlas, for synthetic atlases of
+ * a growing number of frames (animations of 8 frames each).
+ * Both loaders read from memory, file access is not measured.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sciuter/animation.hpp>
+
+const int FRAMES_PER_ANIMATION = 8;
+const int REPETITIONS = 5;
+
+std::string make_atlas_json(const int frame_count)
+{
+    std::string json = "{\"frames\": {";
+
+    for(int i = 0; i < frame_count; ++i)
+    {
+        const int x = (i % 64) * 32;
+        const int y = (i / 64) * 32;
+        json += (i > 0 ? ",\n\"" : "\n\"") + std::to_string(i) + ".png\": {" +
+            "\"frame\": {\"x\":" + std::to_string(x) + ",\"y\":" +
+            std::to_string(y) + ",\"w\":32,\"h\":32}, \"rotated\": false, " +
+            "\"trimmed\": false, " +
+            "\"spriteSourceSize\": {\"x\":0,\"y\":0,\"w\":32,\"h\":32}, " +
+            "\"sourceSize\": {\"w\":32,\"h\":32}}";
+    }
+
+    json += "},\n\"animations\": {";
+    for(int i = 0; i < frame_count / FRAMES_PER_ANIMATION; ++i)
+    {
+        json += (i > 0 ? ",\n\"anim-" : "\n\"anim-") + std::to_string(i) + "\": [";
+        for(int frame = 0; frame < FRAMES_PER_ANIMATION; ++frame)
+        {
+            json += (frame > 0 ? ",\"" : "\"") +
+                std::to_string(i * FRAMES_PER_ANIMATION + frame) + ".png\"";
+        }
+        json += "]";
+    }
+    json += "}}";
+
+    return json;
+}
+
+template<typename Func>
+double measure_ms(Func func)
+{
+    double best = 1e30;
+
+    for(int i = 0; i < REPETITIONS; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const AnimationMap animations = func();
+        const auto end = std::chrono::steady_clock::now();
+
+        if(animations.empty())
+        {
+            printf("load failed\n");
+        }
+        best = std::min(
+            best,
+            std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char* argv[])
+{
+    const int sizes[] = {1000, 10000, 100000};
+
+    printf("%10s %12s %12s %12s %12s\n",
+           "frames", "json KB", "table KB", "json ms", "table ms");
+
+    for(const int frames : sizes)
+    {
+        const std::string json = make_atlas_json(frames);
+        const std::vector<char> table = BinaryAnimationLoader::write(
+            TexturePackerAnimationLoader::load(json.data(), json.size()));
+
+        const double json_ms = measure_ms([&json] {
+            return TexturePackerAnimationLoader::load(json.data(), json.size());
+        });
+        const double table_ms = measure_ms([&table] {
+            return BinaryAnimationLoader::load(table.data(), table.size());
+        });
+
+        printf("%10d %12zu %12zu %12.3f %12.3f\n",
+               frames, json.size() / 1024, table.size() / 1024,
+               json_ms, table_ms);
+    }
+    return 0;
+}
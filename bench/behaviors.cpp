@@ -0,0 +1,141 @@
+/**
+ * Benchmark of behavior dispatch: the same bouncing behavior as a
+ * shared_ptr to a virtual interface per entity, the way behaviors used
+ * to be stored, against the typed behavior pool run by update_behaviors.
+ * Both worlds move with update_linear_velocity so the behaviors keep
+ * flipping directions; the final positions must match.
+ */
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <sciuter/systems.hpp>
+
+const int TICKS = 600;
+const float TICK_TIME = 1.f / 60;
+
+class IEntityBehavior {
+public:
+    virtual ~IEntityBehavior() = default;
+    virtual const bool has_finished() const = 0;
+    virtual void update(const float dt, entt::entity &entity,
+                        entt::registry &registry) = 0;
+};
+
+typedef std::shared_ptr<IEntityBehavior> entity_behavior;
+
+class VirtualBossBehavior : public IEntityBehavior {
+public:
+    virtual const bool has_finished() const {return false;}
+    virtual void update(const float dt, entt::entity &entity,
+                        entt::registry &registry) {
+        auto& position = registry.get<components::position>(entity);
+        auto& direction = registry.get<components::velocity>(entity);
+
+        if (direction.dx < 0 && position.x < 100) {
+            direction.dx = -direction.dx;
+        }
+
+        if (direction.dx > 0 && position.x > 540) {
+            direction.dx = -direction.dx;
+        }
+    }
+};
+
+void update_virtual_behaviors(const float dt, entt::registry &registry)
+{
+    auto view = registry.view<entity_behavior>();
+
+    for (auto entity : view) {
+        auto &behavior = view.get<entity_behavior>(entity);
+
+        behavior->update(dt, entity, registry);
+
+        if (behavior->has_finished()) {
+            registry.destroy(entity);
+        }
+    }
+}
+
+template<typename Func>
+double measure_ms(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template<typename Assign>
+void create_enemies(const int count, entt::registry& registry, Assign assign)
+{
+    std::mt19937 rand_engine(42);
+    std::uniform_real_distribution<float> dist_x(0.f, 640.f);
+    std::uniform_real_distribution<float> dist_speed(20.f, 200.f);
+
+    for(int i = 0; i < count; ++i)
+    {
+        auto enemy = registry.create();
+        registry.assign<components::position>(enemy, dist_x(rand_engine), 0.f);
+        registry.assign<components::velocity>(enemy, 1.f, 0.f, dist_speed(rand_engine));
+        assign(enemy);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int sizes[] = {1000, 10000, 100000};
+
+    printf("%10s %16s %16s %8s\n",
+           "behaviors", "virtual ns/each", "typed ns/each", "speedup");
+
+    for(const int count : sizes)
+    {
+        entt::registry virtual_world;
+        create_enemies(count, virtual_world, [&](const entt::entity enemy) {
+            virtual_world.assign<entity_behavior>(enemy, new VirtualBossBehavior());
+        });
+
+        entt::registry typed_world;
+        create_enemies(count, typed_world, [&](const entt::entity enemy) {
+            typed_world.assign<components::boss_behavior>(enemy);
+        });
+
+        double virtual_ms = 0.0;
+        double typed_ms = 0.0;
+
+        for(int tick = 0; tick < TICKS; ++tick)
+        {
+            virtual_ms += measure_ms([&] {
+                update_virtual_behaviors(TICK_TIME, virtual_world);
+            });
+            typed_ms += measure_ms([&] {
+                update_behaviors(TICK_TIME, typed_world);
+            });
+            update_linear_velocity(TICK_TIME, virtual_world);
+            update_linear_velocity(TICK_TIME, typed_world);
+        }
+
+        // both worlds were created in the same order with the same values
+        auto virtual_view = virtual_world.view<components::position>();
+        auto typed_view = typed_world.view<components::position>();
+        int mismatches = 0;
+        for(auto entity : virtual_view)
+        {
+            if(virtual_view.get(entity).x != typed_view.get(entity).x)
+            {
+                ++mismatches;
+            }
+        }
+        if(mismatches > 0)
+        {
+            printf("%d positions differ\n", mismatches);
+            return 1;
+        }
+
+        const double scale = 1e6 / (double(TICKS) * count);
+        printf("%10d %16.2f %16.2f %7.1fx\n",
+               count, virtual_ms * scale, typed_ms * scale, virtual_ms / typed_ms);
+    }
+    return 0;
+}
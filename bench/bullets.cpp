@@ -0,0 +1,225 @@
+/**
+ * Benchmark of bullet movement: the per entity systems the pool bullets
+ * used to go through (update_linear_velocity, update_destination_rect
+ * and a boundaries check) against BulletPool::update, which runs the
+ * BulletStore kernels and copies the results back to the entities, and
+ * against the bare scalar and SIMD kernels of the store, for 10k, 100k
+ * and 1M bullets spread over the boundaries.
+ * The pool and kernel results are checked against the ECS ones before
+ * timing.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <sciuter/bullet_pool.hpp>
+#include <sciuter/bullet_store.hpp>
+#include <sciuter/command_buffer.hpp>
+#include <sciuter/components.hpp>
+#include <sciuter/systems.hpp>
+
+const int TICKS = 20;
+const float DT = 1.f / 60;
+const SDL_Rect BOUNDARIES = {0, 0, 4096, 4096};
+const SDL_Rect BULLET_RECT = {0, 0, 6, 7};
+
+struct bullet
+{
+    float x, y, dx, dy, speed;
+};
+
+std::vector<bullet> make_bullets(const int count)
+{
+    std::mt19937 rand_engine(count);
+    std::uniform_real_distribution<float> position(0.f, BOUNDARIES.w);
+    std::uniform_real_distribution<float> direction(-1.f, 1.f);
+    std::uniform_real_distribution<float> speed(50.f, 200.f);
+
+    std::vector<bullet> bullets(count);
+    for(auto& b : bullets)
+    {
+        components::velocity velocity = {direction(rand_engine),
+                                         direction(rand_engine), 0.f};
+        velocity.normalize();
+        b = {position(rand_engine), position(rand_engine),
+             velocity.dx, velocity.dy, speed(rand_engine)};
+    }
+    return bullets;
+}
+
+template<typename Func>
+double measure_ms(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(int tick = 0; tick < TICKS; ++tick)
+    {
+        func();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / TICKS;
+}
+
+// bullets as plain entities, moved by the per entity systems
+std::vector<entt::entity> create_entities(const std::vector<bullet>& bullets,
+                                          entt::registry& registry)
+{
+    std::vector<entt::entity> entities;
+    for(const auto& b : bullets)
+    {
+        auto entity = registry.create();
+        registry.assign<components::position>(entity, b.x, b.y);
+        registry.assign<components::velocity>(entity, b.dx, b.dy, b.speed);
+        registry.assign<components::source_rect>(entity, BULLET_RECT);
+        registry.assign<components::destination_rect>(entity);
+        entities.push_back(entity);
+    }
+    return entities;
+}
+
+// the boundaries check of the per entity path
+void check_boundaries(CommandBuffer& commands, entt::registry& registry)
+{
+    auto view = registry.view<components::destination_rect>(
+        entt::exclude<components::inactive>);
+
+    for(auto entity: view) {
+        auto &dest_rect = view.get(entity);
+
+        if(!SDL_HasIntersection(&dest_rect, &BOUNDARIES))
+        {
+            commands.assign<components::inactive>(entity);
+        }
+    }
+}
+
+void update_entities(CommandBuffer& commands, entt::registry& registry)
+{
+    update_linear_velocity(DT, registry);
+    update_destination_rect(registry);
+    check_boundaries(commands, registry);
+    commands.flush(registry);
+}
+
+std::vector<entt::entity> acquire_bullets(const std::vector<bullet>& bullets,
+                                          BulletPool& pool,
+                                          entt::registry& registry)
+{
+    pool.set_prototype(COLLISION_MASK_PLAYER, nullptr, BULLET_RECT, 1);
+    pool.reserve(bullets.size(), registry);
+
+    std::vector<entt::entity> entities;
+    for(const auto& b : bullets)
+    {
+        entities.push_back(pool.acquire({b.x, b.y}, {b.dx, b.dy, b.speed},
+                                        COLLISION_MASK_PLAYER, registry));
+    }
+    return entities;
+}
+
+// one tick of every path must give the same rects and removals
+bool check(const std::vector<bullet>& bullets)
+{
+    entt::registry ecs_world;
+    CommandBuffer ecs_commands;
+    const auto ecs_entities = create_entities(bullets, ecs_world);
+    update_entities(ecs_commands, ecs_world);
+
+    entt::registry pool_world;
+    BulletPool pool(pool_world, BOUNDARIES);
+    CommandBuffer pool_commands;
+    const auto pool_entities = acquire_bullets(bullets, pool, pool_world);
+    pool.update(DT, pool_commands, pool_world);
+    pool_commands.flush(pool_world);
+
+    BulletStore stores[2];
+    const BulletStore::kernel kernels[] = {
+        BulletStore::kernel::scalar, BulletStore::kernel::simd};
+    for(int k = 0; k < 2; ++k)
+    {
+        for(const auto& b : bullets)
+        {
+            stores[k].add(b.x, b.y, b.dx, b.dy, b.speed, BULLET_RECT.w, BULLET_RECT.h);
+        }
+        stores[k].update(DT, BOUNDARIES, kernels[k]);
+    }
+
+    for(size_t i = 0; i < bullets.size(); ++i)
+    {
+        const SDL_Rect& expected = ecs_world.get<components::destination_rect>(ecs_entities[i]);
+        const bool parked = ecs_world.has<components::inactive>(ecs_entities[i]);
+        const SDL_Rect& pooled = pool_world.get<components::destination_rect>(pool_entities[i]);
+
+        if(pooled.x != expected.x || pooled.y != expected.y ||
+           pool_world.has<components::inactive>(pool_entities[i]) != parked)
+        {
+            return false;
+        }
+        for(auto& store : stores)
+        {
+            const SDL_Rect rect = store.get_rect(i);
+            if(rect.x != expected.x || rect.y != expected.y ||
+               store.get_outside()[i] != parked)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const int sizes[] = {10000, 100000, 1000000};
+
+    printf("simd kernel: %s\n", BulletStore::get_simd_name());
+    printf("%10s %12s %12s %12s %12s\n",
+           "bullets", "ecs ms", "pool ms", "scalar ms", "simd ms");
+
+    for(const int count : sizes)
+    {
+        const std::vector<bullet> bullets = make_bullets(count);
+
+        if(!check(bullets))
+        {
+            printf("%10d results differ from the ECS path\n", count);
+            return 1;
+        }
+
+        entt::registry ecs_world;
+        CommandBuffer ecs_commands;
+        create_entities(bullets, ecs_world);
+        const double ecs_ms = measure_ms([&] {
+            update_entities(ecs_commands, ecs_world);
+        });
+
+        entt::registry pool_world;
+        BulletPool pool(pool_world, BOUNDARIES);
+        CommandBuffer pool_commands;
+        acquire_bullets(bullets, pool, pool_world);
+        const double pool_ms = measure_ms([&] {
+            pool.update(DT, pool_commands, pool_world);
+            pool_commands.flush(pool_world);
+        });
+
+        double store_ms[2];
+        const BulletStore::kernel kernels[] = {
+            BulletStore::kernel::scalar, BulletStore::kernel::simd};
+        for(int k = 0; k < 2; ++k)
+        {
+            BulletStore store;
+            store.reserve(count);
+            for(const auto& b : bullets)
+            {
+                store.add(b.x, b.y, b.dx, b.dy, b.speed, BULLET_RECT.w, BULLET_RECT.h);
+            }
+            store_ms[k] = measure_ms([&] {
+                store.update(DT, BOUNDARIES, kernels[k]);
+            });
+        }
+
+        printf("%10d %12.3f %12.3f %12.3f %12.3f\n",
+               count, ecs_ms, pool_ms, store_ms[0], store_ms[1]);
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+/**
+ * Benchmark of the collision system: compares the grid broadphase used
+ * by resolve_collisions with the brute force bullets x targets loop it
+ * replaced, for a growing number of colliders.
+ * The scene keeps the density of a crowded screen (about 2000 bullets
+ * and 300 enemies every 640x480 pixels), the world grows with the
+ * number of colliders.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <sciuter/components.hpp>
+#include <sciuter/spatial_grid.hpp>
+#include <sciuter/systems.hpp>
+
+const int SCREEN_AREA = 640 * 480;
+const int COLLIDERS_PER_SCREEN = 2300;
+const int REPETITIONS = 5;
+
+SDL_Rect world_rect(const int colliders)
+{
+    const float screens = std::max(1.f, (float)colliders / COLLIDERS_PER_SCREEN);
+    const int side = sqrt(screens * SCREEN_AREA);
+    return {0, 0, side, side};
+}
+
+void create_scene(const int colliders, const SDL_Rect& world,
+                  entt::registry& registry)
+{
+    std::mt19937 rand_engine(colliders);
+    std::uniform_int_distribution<> dist_x(0, world.w);
+    std::uniform_int_distribution<> dist_y(0, world.h);
+
+    // roughly the same bullets/targets ratio of a bullet hell wave
+    const int targets = colliders / 8;
+
+    for(int i = 0; i < colliders; ++i)
+    {
+        auto entity = registry.create();
+        if(i < targets)
+        {
+            registry.assign<components::destination_rect>(
+                entity, dist_x(rand_engine), dist_y(rand_engine), 42, 30);
+            registry.assign<components::collision_mask>(
+                entity, COLLISION_MASK_ENEMIES);
+            registry.assign<components::energy>(entity, 100);
+        }
+        else
+        {
+            registry.assign<components::destination_rect>(
+                entity, dist_x(rand_engine), dist_y(rand_engine), 8, 8);
+            registry.assign<components::collision_mask>(
+                entity, COLLISION_MASK_ENEMIES);
+            registry.assign<components::damage>(entity, 10);
+        }
+    }
+}
+
+// the O(bullets x targets) version resolve_collisions used to be
+void resolve_collisions_brute_force(entt::registry& registry)
+{
+    auto view_bullets = registry.view<
+        components::destination_rect,
+        components::collision_mask,
+        components::damage>();
+    auto view_targets = registry.view<
+        components::destination_rect,
+        components::collision_mask,
+        components::energy>();
+
+    for(auto bullet: view_bullets) {
+        auto &bullet_mask = view_bullets.get<components::collision_mask>(bullet);
+        auto &bullet_rect = view_bullets.get<components::destination_rect>(bullet);
+        auto &damage = view_bullets.get<components::damage>(bullet);
+
+        for(auto target: view_targets) {
+            auto &target_mask = view_targets.get<components::collision_mask>(target);
+            auto &target_rect = view_targets.get<components::destination_rect>(target);
+            auto &energy = view_targets.get<components::energy>(target);
+
+            if(!registry.valid(bullet) || !registry.valid(target)) continue;
+
+            if((bullet_mask.value & target_mask.value) != 0 &&
+               SDL_HasIntersection(&bullet_rect, &target_rect))
+            {
+                registry.destroy(bullet);
+                energy.value -= damage.value;
+
+                if(energy.value <= 0)
+                {
+                    registry.destroy(target);
+                }
+            }
+        }
+    }
+}
+
+template<typename Func>
+double measure_ms(const int colliders, Func func)
+{
+    double best = 1e30;
+    const SDL_Rect world = world_rect(colliders);
+
+    for(int i = 0; i < REPETITIONS; ++i)
+    {
+        entt::registry registry;
+        create_scene(colliders, world, registry);
+
+        const auto start = std::chrono::steady_clock::now();
+        func(world, registry);
+        const auto end = std::chrono::steady_clock::now();
+
+        best = std::min(
+            best,
+            std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char* argv[])
+{
+    const int sizes[] = {100, 1000, 10000, 100000};
+    // the brute force loop takes minutes past this size
+    const int brute_force_limit = 10000;
+
+    printf("%10s %16s %16s\n", "colliders", "brute force ms", "grid ms");
+
+    for(const int colliders : sizes)
+    {
+        const double grid_ms = measure_ms(
+            colliders,
+            [](const SDL_Rect& world, entt::registry& registry) {
+                SpatialGrid grid(world);
+                CommandBuffer commands;
+                resolve_collisions(grid, commands, registry);
+                commands.flush(registry);
+            });
+
+        if(colliders <= brute_force_limit)
+        {
+            const double brute_ms = measure_ms(
+                colliders,
+                [](const SDL_Rect&, entt::registry& registry) {
+                    resolve_collisions_brute_force(registry);
+                });
+            printf("%10d %16.3f %16.3f\n", colliders, brute_ms, grid_ms);
+        }
+        else
+        {
+            printf("%10d %16s %16.3f\n", colliders, "-", grid_ms);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * Benchmark of the command buffer memory: the same commands, moving
+ * every entity and retargeting its velocity, are recorded and flushed
+ * every frame with the commands allocated from the heap and from the
+ * FrameArena swapped at the end of the frame. Both worlds must end in
+ * the same state.
+ */
+#include <chrono>
+#include <cstdio>
+#include <sciuter/command_buffer.hpp>
+#include <sciuter/components.hpp>
+#include <sciuter/frame_arena.hpp>
+
+const int FRAMES = 120;
+
+template<typename Func>
+double measure_ms(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void create_entities(const int count, entt::registry& registry)
+{
+    for(int i = 0; i < count; ++i)
+    {
+        auto entity = registry.create();
+        registry.assign<components::position>(entity, float(i % 640), 0.f);
+        registry.assign<components::velocity>(entity, 0.f, 1.f, 60.f);
+    }
+}
+
+void record_frame(const int frame, CommandBuffer& commands, entt::registry& registry)
+{
+    auto view = registry.view<components::position>();
+
+    for(auto entity : view)
+    {
+        auto& position = view.get(entity);
+        commands.assign<components::position>(entity, position.x, position.y + 1.f);
+        commands.assign<components::velocity>(entity, 0.f, frame % 2 ? 1.f : -1.f, 60.f);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int sizes[] = {1000, 10000, 100000};
+
+    printf("%10s %16s %16s %8s %14s\n",
+           "commands", "heap ms/frame", "arena ms/frame", "speedup", "arena bytes");
+
+    for(const int count : sizes)
+    {
+        entt::registry heap_world;
+        create_entities(count, heap_world);
+        CommandBuffer heap_commands;
+
+        entt::registry arena_world;
+        create_entities(count, arena_world);
+        FrameArena arena;
+        CommandBuffer arena_commands(&arena);
+
+        double heap_ms = 0.0;
+        double arena_ms = 0.0;
+        size_t arena_bytes = 0;
+
+        for(int frame = 0; frame < FRAMES; ++frame)
+        {
+            heap_ms += measure_ms([&] {
+                record_frame(frame, heap_commands, heap_world);
+                heap_commands.flush(heap_world);
+            });
+            arena_ms += measure_ms([&] {
+                record_frame(frame, arena_commands, arena_world);
+                arena_commands.flush(arena_world);
+                arena_bytes = arena.get_bytes();
+                arena.swap();
+            });
+        }
+
+        auto heap_view = heap_world.view<components::position>();
+        auto arena_view = arena_world.view<components::position>();
+        int mismatches = 0;
+        for(auto entity : heap_view)
+        {
+            if(heap_view.get(entity).y != arena_view.get(entity).y)
+            {
+                ++mismatches;
+            }
+        }
+        if(mismatches > 0)
+        {
+            printf("%d positions differ\n", mismatches);
+            return 1;
+        }
+
+        printf("%10d %16.3f %16.3f %7.1fx %14zu\n",
+               count * 2, heap_ms / FRAMES, arena_ms / FRAMES,
+               heap_ms / arena_ms, arena_bytes);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * Benchmark of camera culling on a long scrolling level: enemies are
+ * spread over a level 100 screens high, the camera scrolls through it and
+ * every frame rebuilds the destination rects and draws the sprites with
+ * the software renderer, with and without culling the entities out of
+ * view.
+ */
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sciuter/render_order.hpp>
+#include <sciuter/sdl.hpp>
+#include <sciuter/sprite_batch.hpp>
+#include <sciuter/systems.hpp>
+
+const int FRAMES = 120;
+const SDL_Rect SCREEN = {0, 0, 640, 480};
+const int LEVEL_HEIGHT = SCREEN.h * 100;
+// pixels per frame, faster than the game to cross more entities
+const int SCROLL_SPEED = 4;
+
+template<typename Func>
+double measure_ms(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+struct frame_result
+{
+    double ms;
+    int sprites;
+};
+
+frame_result run_frames(const int enemies,
+                        const bool cull,
+                        SDL_Renderer* renderer,
+                        SDL_Texture* texture)
+{
+    entt::registry registry;
+    RenderOrder render_order(registry);
+    SpriteBatch batch;
+    std::mt19937 rand_engine(42);
+    std::uniform_real_distribution<float> dist_x(0.f, SCREEN.w);
+    std::uniform_real_distribution<float> dist_y(0.f, LEVEL_HEIGHT);
+
+    for(int i = 0; i < enemies; ++i)
+    {
+        auto enemy = registry.create();
+        registry.assign<components::position>(enemy, dist_x(rand_engine), dist_y(rand_engine));
+        registry.assign<components::world_position>(enemy);
+        registry.assign<components::source_rect>(enemy, SDL_Rect{0, 0, 16, 16});
+        registry.assign<components::destination_rect>(enemy);
+        registry.assign<components::image>(enemy, texture);
+        registry.assign<components::draw_order>(enemy, 1);
+    }
+
+    auto camera = registry.create();
+    registry.assign<components::position>(camera, 0.f, 0.f);
+
+    int sprites = 0;
+    const double ms = measure_ms([&] {
+        for(int frame = 0; frame < FRAMES; ++frame)
+        {
+            auto &camera_pos = registry.get<components::position>(camera);
+            camera_pos.y = LEVEL_HEIGHT / 2 - frame * SCROLL_SPEED;
+
+            if(cull)
+            {
+                cull_offscreen(camera, SCREEN, CULL_MARGIN, registry);
+            }
+            update_destination_rect(registry);
+            apply_camera_transformation(camera, registry);
+            render_sprites(renderer, batch, render_order, registry);
+            sprites += batch.get_sprites();
+        }
+    }) / FRAMES;
+
+    return {ms, sprites / FRAMES};
+}
+
+int main(int argc, char* argv[])
+{
+    const int sizes[] = {1000, 10000, 100000};
+
+    if(!sdl_init_headless())
+    {
+        return 1;
+    }
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(
+        0, SCREEN.w, SCREEN.h, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+    SDL_Texture* texture = SDL_CreateTexture(
+        renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 16);
+
+    printf("%10s %14s %14s %14s %14s\n",
+           "enemies", "all ms/frame", "sprites", "culled ms", "sprites");
+
+    for(const int enemies : sizes)
+    {
+        const frame_result all = run_frames(enemies, false, renderer, texture);
+        const frame_result culled = run_frames(enemies, true, renderer, texture);
+
+        printf("%10d %14.3f %14d %14.3f %14d\n",
+               enemies, all.ms, all.sprites, culled.ms, culled.sprites);
+    }
+
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    sdl_quit(nullptr);
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * Benchmark of startup asset loading: every image and animation of the
+ * game loaded one after another on the main thread, against the same
+ * set loaded through ResourceLoader on a thread pool.
+ * The asset set is loaded several times under different ids to get
+ * measurable times; run it from the project root.
+ */
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <sciuter/resource_loader.hpp>
+#include <sciuter/resources.hpp>
+#include <sciuter/sdl.hpp>
+#include <sciuter/work_stealing_pool.hpp>
+
+const char* IMAGES[] = {
+    "resources/images/background.png",
+    "resources/images/player.png",
+    "resources/images/ufo.png",
+    "resources/images/boss.png",
+    "resources/images/bullet.png",
+    "resources/images/bullet-enemy.png",
+    "resources/images/bullet-enemy-small.png",
+};
+
+const char* ANIMATIONS[] = {
+    "resources/images/player.json",
+    "resources/images/ufo.json",
+};
+
+const int COPIES = 16;
+
+// every run and copy gets its own ids, so that nothing is cached
+entt::hashed_string::hash_type asset_id(const std::string& run,
+                                        const char* path,
+                                        const int copy)
+{
+    const std::string name = run + ":" + path + ":" + std::to_string(copy);
+    return entt::hashed_string::to_value(name.c_str());
+}
+
+double load_serial(SDL_Renderer* renderer)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for(int copy = 0; copy < COPIES; ++copy)
+    {
+        for(auto path : IMAGES)
+        {
+            Resources::load_texture(asset_id("serial", path, copy), path, renderer);
+        }
+        for(auto path : ANIMATIONS)
+        {
+            Resources::load_animations(asset_id("serial", path, copy), path);
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double load_parallel(WorkStealingPool& pool, SDL_Renderer* renderer)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    ResourceLoader loader(pool);
+    for(int copy = 0; copy < COPIES; ++copy)
+    {
+        for(auto path : IMAGES)
+        {
+            loader.load_texture(asset_id("parallel", path, copy), path);
+        }
+        for(auto path : ANIMATIONS)
+        {
+            loader.load_animations(asset_id("parallel", path, copy), path);
+        }
+    }
+    loader.finish(renderer);
+
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    if(!sdl_init_headless())
+    {
+        return 1;
+    }
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(
+        0, 640, 480, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+
+    {
+        // threads are started before timing, like they would be at startup
+        WorkStealingPool pool;
+        const double serial_ms = load_serial(renderer);
+        const double parallel_ms = load_parallel(pool, renderer);
+
+        printf("%d assets, %zu threads\n",
+               COPIES * (int)(std::size(IMAGES) + std::size(ANIMATIONS)),
+               pool.size());
+        printf("serial   %10.3f ms\n", serial_ms);
+        printf("parallel %10.3f ms\n", parallel_ms);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    sdl_quit(nullptr);
+    return 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * Benchmark of the bullet pattern engine: patterns are fired into a warm
+ * pool until the given number of bullets is alive, measuring the cost
+ * of firing per bullet, then the pool update of a 60 Hz tick runs
+ * over all of them.
+ * Bullets never leave the (huge) boundaries, so the live count stays
+ * fixed while measuring ticks.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sciuter/bullet_patterns.hpp>
+#include <sciuter/bullet_pool.hpp>
+#include <sciuter/command_buffer.hpp>
+#include <sciuter/components.hpp>
+#include <sciuter/systems.hpp>
+
+const int TICKS = 60;
+
+template<typename Func>
+double measure_ms(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    const int sizes[] = {10000, 50000, 100000};
+
+    BulletPatterns patterns;
+
+    // spiral of 4 arms turning 10 degrees per shot
+    bullet_pattern spiral;
+    spiral.count = 4;
+    spiral.spin = 0.1745f;
+    spiral.phases = 36;
+    spiral.speed = 120.f;
+    const auto spiral_id = patterns.add(spiral);
+
+    // aimed fans of 5 on a ring of 8, in 3 staggered waves
+    bullet_pattern fan;
+    fan.shape = pattern_shape::fan;
+    fan.count = 5;
+    fan.spread = 0.5f;
+    fan.speed = 90.f;
+    const auto fan_id = patterns.add(fan);
+
+    bullet_pattern rings;
+    rings.count = 8;
+    rings.speed = 90.f;
+    rings.waves = 3;
+    rings.speed_step = 30.f;
+    rings.aimed = true;
+    rings.child = fan_id;
+    const auto rings_id = patterns.add(rings);
+
+    printf("%10s %14s %14s %14s\n",
+           "bullets", "fire ns/bullet", "tick ms", "tick ns/bullet");
+
+    for(const int live : sizes)
+    {
+        const SDL_Rect world = {-1000000, -1000000, 2000000, 2000000};
+        entt::registry registry;
+        BulletPool bullets(registry, world);
+        CommandBuffer commands;
+        bullets.set_prototype(COLLISION_MASK_PLAYER, nullptr, {0, 0, 8, 8}, 10);
+        // the pool is warm in a running game, don't measure its growth
+        bullets.reserve(live + 1024, registry);
+
+        int fired = 0;
+        Uint32 shot = 0;
+        const components::velocity aim = {0.6f, 0.8f, 0.f};
+
+        const double fire_ms = measure_ms([&] {
+            while(fired < live)
+            {
+                const auto pattern = shot % 2 ? spiral_id : rings_id;
+                patterns.fire(pattern, shot++, {320.f, 240.f}, aim,
+                              COLLISION_MASK_PLAYER, bullets, registry);
+                fired += patterns.get_bullet_count(pattern);
+            }
+        });
+
+        const double tick_ms = measure_ms([&] {
+            for(int tick = 0; tick < TICKS; ++tick)
+            {
+                bullets.update(1.f / 60, commands, registry);
+                commands.flush(registry);
+            }
+        }) / TICKS;
+
+        printf("%10d %14.1f %14.3f %14.1f\n",
+               fired, fire_ms * 1e6 / fired, tick_ms, tick_ms * 1e6 / fired);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * Benchmark of the script scheduler: every entity runs a script that
+ * keeps waiting a random time between 1 and 4 seconds, so about the
+ * same share of the scripts wakes up at every tick. The cost of a tick
+ * should follow the scripts woken up, not the ones waiting.
+ */
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sciuter/scripts.hpp>
+
+const int TICKS = 600;
+const float TICK_TIME = 1.f / 60;
+
+template<typename Func>
+double measure_ms(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static int s_resumed = 0;
+
+script idle(const float first_wait, const Uint32 seed)
+{
+    std::minstd_rand rand_engine(seed);
+    std::uniform_real_distribution<float> dist(1.f, 4.f);
+
+    co_await scripts::wait(first_wait);
+    for(;;)
+    {
+        s_resumed += 1;
+        co_await scripts::wait(dist(rand_engine));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int sizes[] = {1000, 10000, 100000, 1000000};
+
+    printf("%10s %12s %14s %12s %14s\n",
+           "scripts", "start ns", "resumed/tick", "tick us", "ns/resume");
+
+    for(const int count : sizes)
+    {
+        entt::registry registry;
+        BulletPatterns patterns;
+        BulletPool bullets(registry, {0, 0, 640, 480});
+        ScriptScheduler scheduler(patterns, bullets, registry);
+        std::mt19937 rand_engine(42);
+        std::uniform_real_distribution<float> dist(0.f, 4.f);
+
+        const double start_ms = measure_ms([&] {
+            for(int i = 0; i < count; ++i)
+            {
+                scheduler.start(registry.create(), idle(dist(rand_engine), i));
+            }
+        });
+
+        // the first update starts every script
+        scheduler.update(TICK_TIME);
+        s_resumed = 0;
+
+        const double tick_ms = measure_ms([&] {
+            for(int tick = 0; tick < TICKS; ++tick)
+            {
+                scheduler.update(TICK_TIME);
+            }
+        }) / TICKS;
+
+        const double resumed = double(s_resumed) / TICKS;
+        printf("%10d %12.1f %14.1f %12.1f %14.1f\n",
+               count, start_ms * 1e6 / count, resumed,
+               tick_ms * 1e3, tick_ms * 1e6 / std::max(resumed, 1.0));
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * Benchmark of timer updates: the countdown timer decremented by a view
+ * over every timer each tick, the way update_timers used to work, against
+ * the TimerWheel touching only the timers expiring. Timers get periods
+ * between half a second and ten seconds like enemy weapons, so most of
+ * them sit idle in any tick. The wheel rounds periods to whole ticks so
+ * the expirations of the two are counted but not compared.
+ */
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sciuter/timer_wheel.hpp>
+
+const int TICKS = 600;
+const float TICK_TIME = 1.f / 60;
+
+struct countdown_timer
+{
+    float timeout;
+    float reset_time;
+
+    countdown_timer(const float time) : timeout(time), reset_time(time) {}
+
+    const float update(const float dt) {
+        if(timeout <= 0.f) {
+            timeout += reset_time;
+        }
+        timeout -= dt;
+        return timeout;
+    }
+
+    const bool timed_out() const { return timeout <= 0.f; }
+};
+
+size_t update_countdown_timers(const float dt, entt::registry& registry)
+{
+    auto view = registry.view<countdown_timer>();
+    size_t fired = 0;
+
+    for(auto entity: view) {
+        auto &timer = view.get(entity);
+        timer.update(dt);
+        fired += timer.timed_out();
+    }
+    return fired;
+}
+
+template<typename Func>
+double measure_ms(Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template<typename Assign>
+void create_timers(const int count, entt::registry& registry, Assign assign)
+{
+    std::mt19937 rand_engine(42);
+    std::uniform_real_distribution<float> dist_period(0.5f, 10.f);
+
+    for(int i = 0; i < count; ++i)
+    {
+        assign(registry.create(), dist_period(rand_engine));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int sizes[] = {1000, 10000, 100000, 1000000};
+
+    printf("%10s %16s %16s %8s %12s %12s\n",
+           "timers", "countdown ms", "wheel ms", "speedup",
+           "countdown #", "wheel #");
+
+    for(const int count : sizes)
+    {
+        entt::registry countdown_world;
+        create_timers(count, countdown_world,
+                      [&](const entt::entity entity, const float period) {
+            countdown_world.assign<countdown_timer>(entity, period);
+        });
+
+        entt::registry wheel_world;
+        TimerWheel wheel(wheel_world);
+        create_timers(count, wheel_world,
+                      [&](const entt::entity entity, const float period) {
+            wheel_world.assign<components::timer>(entity, period);
+        });
+        // the first update schedules every timer, keep it out of the loop
+        wheel.update(TICK_TIME);
+
+        double countdown_ms = 0.0;
+        double wheel_ms = 0.0;
+        size_t countdown_fired = 0;
+        size_t wheel_fired = 0;
+
+        for(int tick = 0; tick < TICKS; ++tick)
+        {
+            countdown_ms += measure_ms([&] {
+                countdown_fired += update_countdown_timers(TICK_TIME, countdown_world);
+            });
+            wheel_ms += measure_ms([&] {
+                wheel.update(TICK_TIME);
+            });
+            wheel_fired += wheel.get_fired().size();
+        }
+
+        printf("%10d %16.4f %16.4f %7.1fx %12zu %12zu\n",
+               count, countdown_ms / TICKS, wheel_ms / TICKS,
+               countdown_ms / wheel_ms, countdown_fired, wheel_fired);
+    }
+    return 0;
+}
@@ -3693,13 +3693,17 @@ public:
 
 template<typename Entity>
 constexpr bool operator==(const Entity entity, null other) ENTT_NOEXCEPT {
-    return other == entity;
+    // sciuter patch, keep it when upgrading EnTT: upstream returns
+    // other == entity, which C++20 resolves to this very operator with
+    // the arguments reversed, recursing forever
+    return other.operator==(entity);
 }
 
 
 template<typename Entity>
 constexpr bool operator!=(const Entity entity, null other) ENTT_NOEXCEPT {
-    return other != entity;
+    // sciuter patch, see operator== above
+    return other.operator!=(entity);
 }
 
 
@@ -25,6 +25,17 @@ class Animation
             : m_frames(frames), m_name(name){}
 
         const std::vector<SDL_Rect>& get_frames() const { return m_frames; }
+        const std::string& get_name() const { return m_name; }
+
+        // move every frame by x, y pixels
+        void offset(const int x, const int y)
+        {
+            for(auto& frame : m_frames)
+            {
+                frame.x += x;
+                frame.y += y;
+            }
+        }
         const int get_frame_count() const { return m_frames.size(); }
 };
 
@@ -35,6 +46,50 @@ class TexturePackerAnimationLoader
     public:
         static AnimationMap load(const std::string filename);
         static AnimationMap load(std::istream &input);
+        // parse a json already in memory, like an asset pack entry
+        static AnimationMap load(const char* data, const size_t size);
+};
+
+/**
+ * Precompiled animation tables, a compact binary form of the TexturePacker
+ * json produced offline (sciuter_animations, sciuter_pack) and loaded
+ * without parsing, native endianness:
+ * - animation_table_header
+ * - frame_count SDL_Rect, the frames of every animation one after another
+ * - animation_count animation_range
+ * - names_size bytes of animation names, not null terminated
+ */
+const char ANIMATION_TABLE_MAGIC[4] = {'S', 'C', 'A', 'N'};
+const Uint32 ANIMATION_TABLE_VERSION = 1;
+
+struct animation_table_header
+{
+    char magic[4];
+    Uint32 version;
+    Uint32 frame_count;
+    Uint32 animation_count;
+    Uint32 names_size;
+};
+
+struct animation_range
+{
+    Uint32 name_offset;
+    Uint32 name_size;
+    Uint32 first_frame;
+    Uint32 frame_count;
+};
+
+class BinaryAnimationLoader
+{
+    public:
+        static std::vector<char> write(const AnimationMap& animations);
+
+        /**
+         * data must be aligned to 4 bytes; the table is bounds checked,
+         * a malformed one gives an empty map
+         */
+        static AnimationMap load(const char* data, const size_t size);
+        static AnimationMap load(const std::string filename);
 };
 
 #endif
@@ -0,0 +1,87 @@
+/**
+ * Asset pack: every game asset bundled in a single indexed file, built
+ * offline by the sciuter_pack tool and memory mapped at runtime.
+ * Assets are handed out as byte ranges of the mapping, so decoding them
+ * (SDL_RWFromConstMem, json parsing) copies nothing.
+ *
+ * Layout, native endianness:
+ * - pack_header
+ * - entry_count pack_entry, sorted by id
+ * - asset data, every asset aligned to PACK_ALIGNMENT
+ */
+#ifndef __SCIUTER_ASSET_PACK_HPP__
+#define __SCIUTER_ASSET_PACK_HPP__
+
+#include <string>
+#include <vector>
+#include <sciuter/sdl.hpp>
+
+const char PACK_MAGIC[4] = {'S', 'C', 'P', 'K'};
+const Uint32 PACK_VERSION = 2;
+const Uint64 PACK_ALIGNMENT = 16;
+
+enum class asset_type : Uint32
+{
+    image = 1,        // an image file SDL_image can decode
+    animations = 2,   // a precompiled animation table
+};
+
+struct pack_header
+{
+    char magic[4];
+    Uint32 version;
+    Uint32 entry_count;
+    Uint32 reserved;
+};
+
+struct pack_entry
+{
+    // hashed name of the asset, the same value of "name"_hs
+    Uint32 id;
+    asset_type type;
+    Uint64 offset;
+    Uint64 size;
+};
+
+struct asset
+{
+    asset_type type;
+    const void* data;
+    size_t size;
+};
+
+class AssetPack
+{
+    private:
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+        // used when the platform can't map files
+        std::vector<char> m_buffer;
+        const pack_entry* m_entries = nullptr;
+        Uint32 m_entry_count = 0;
+
+        void close();
+        bool validate(const std::string& path);
+
+    public:
+        AssetPack() {}
+        ~AssetPack() { close(); }
+        AssetPack(const AssetPack&) = delete;
+        AssetPack& operator=(const AssetPack&) = delete;
+
+        // map the pack, false if missing or malformed
+        bool open(const std::string& path);
+
+        const bool is_open() const { return nullptr != m_data; }
+
+        const Uint32 get_entry_count() const { return m_entry_count; }
+        const pack_entry& get_entry(const Uint32 index) const { return m_entries[index]; }
+
+        // false if the pack has no asset with that id
+        bool find(const Uint32 id, asset& result) const;
+
+        // the asset data as a read only SDL stream, nullptr if missing
+        SDL_RWops* open_stream(const Uint32 id) const;
+};
+
+#endif
@@ -0,0 +1,43 @@
+/**
+ * Skyline rectangle packer used to build texture atlases: the packed
+ * area is described by its top outline (the skyline), a list of
+ * horizontal segments; every rect is placed where it keeps the skyline
+ * lowest (bottom-left rule).
+ */
+#ifndef __SCIUTER_ATLAS_HPP__
+#define __SCIUTER_ATLAS_HPP__
+
+#include <vector>
+#include <sciuter/sdl.hpp>
+
+class SkylinePacker
+{
+    private:
+        struct segment
+        {
+            int x;
+            int y;
+            int width;
+        };
+
+        int m_width;
+        int m_height;
+        std::vector<segment> m_skyline;
+
+        // lowest y a w x h rect can sit at starting on segment index, -1 if it doesn't fit
+        int fit(const size_t index, const int w, const int h) const;
+
+    public:
+        SkylinePacker(const int width, const int height);
+
+        /**
+         * Place a w x h rect, false when the area is full; packed rects
+         * never overlap
+         */
+        bool insert(const int w, const int h, SDL_Rect& result);
+
+        const int get_width() const { return m_width; }
+        const int get_height() const { return m_height; }
+};
+
+#endif
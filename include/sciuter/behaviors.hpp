@@ -1,58 +1,45 @@
+/**
+ * Behaviors are plain data components, one pool per behavior type, and
+ * update_behaviors runs a loop per type over them: no virtual calls and
+ * no allocation per entity. A new behavior is a struct here plus its
+ * loop in update_behaviors.
+ * The boss group owns the position and velocity pools, so that its loop
+ * walks packed arrays; other behavior types can only own their own pool.
+ */
 #ifndef __SCIUTER_BEHAVIORS_HPP__
 #define __SCIUTER_BEHAVIORS_HPP__
 
 #include <sciuter/components.hpp>
 
-class BossBehavior : public components::IEntityBehavior {
-public:
-    virtual const bool has_finished() const {return false;}
-    virtual void update(const float dt, entt::entity &entity,
-                        entt::registry &registry) {
-	auto& position = registry.get<components::position>(entity);
-	auto& direction = registry.get<components::velocity>(entity);
-
-        if (direction.dx < 0 && position.x < 100) {
-          direction.dx = -direction.dx;
-        }
-
-        if (direction.dx > 0 && position.x > 540) {
-          direction.dx = -direction.dx;
+namespace components
+{
+    // moves back and forth horizontally between min_x and max_x
+    struct boss_behavior
+    {
+        float min_x = 100.f;
+        float max_x = 540.f;
+
+        void update(const position& position, velocity& direction) const
+        {
+            if (direction.dx < 0 && position.x < min_x) {
+                direction.dx = -direction.dx;
+            }
+
+            if (direction.dx > 0 && position.x > max_x) {
+                direction.dx = -direction.dx;
+            }
         }
-    }
-};
-
-class EnemySpawnerBehavior : components::IEntityBehavior {
-private:
-    int enemy_count;
-    float delay;
-    float next_delay;
-    entt::entity camera;
-public:
-  EnemySpawnerBehavior(const int enemy_count_,
-		       const float delay_,
-                       const entt::entity &camera_) {
-      enemy_count = enemy_count_;
-      delay = delay_;
-      next_delay = delay_;
-      camera = camera_;
-  }
-  virtual const bool has_finished() const { return true; }
-  virtual void update(const float dt, entt::entity &entity,
-                      entt::registry &registry) {
-
-      delay -= dt;
-      if(delay > 0) return; // still no time to spawn
-
-      delay += next_delay;
-
-      if(enemy_count < 0) return;
-
-      enemy_count -= 1;
-
-      auto position = registry.get<components::position>(entity);
-      auto enemy = registry.create();
-      registry.assign<components::position>(enemy, position);
-  }
-};
+    };
+}
+
+// creating a group sorts the pools it owns, so it is created once up
+// front and not by a system running concurrently with others
+inline auto boss_behavior_group(entt::registry& registry)
+{
+    return registry.group<
+        components::boss_behavior,
+        components::position,
+        components::velocity>();
+}
 
 #endif
@@ -0,0 +1,101 @@
+/**
+ * Bullet pattern engine: rings, fans, spirals, staggered bursts and
+ * patterns nested into other patterns are described as data
+ * (bullet_pattern) and compiled once into direction tables, so firing
+ * a shot costs a table walk and a pool acquire per bullet, sin and cos
+ * are never evaluated while playing.
+ */
+#ifndef __SCIUTER_BULLET_PATTERNS_HPP__
+#define __SCIUTER_BULLET_PATTERNS_HPP__
+
+#include <vector>
+#include <entt/entt.hpp>
+#include <sciuter/bullet_pool.hpp>
+#include <sciuter/components.hpp>
+
+enum class pattern_shape : Uint8
+{
+    ring,   // count directions evenly spaced on a full turn
+    fan,    // count directions evenly spaced on spread radians
+};
+
+/**
+ * Angles are in radians, 0 is straight down (or toward the target for
+ * aimed patterns) and positive angles turn counterclockwise on screen
+ */
+struct bullet_pattern
+{
+    pattern_shape shape = pattern_shape::ring;
+    Uint32 count = 1;
+    float spread = 0.f;
+    // rotation of the whole pattern
+    float angle = 0.f;
+    float speed = 100.f;
+    // staggered burst: waves copies of the shape, each speed_step faster
+    Uint32 waves = 1;
+    float speed_step = 0.f;
+    // spiral: every shot turns the pattern by spin, for phases shots
+    // before starting over
+    float spin = 0.f;
+    Uint32 phases = 1;
+    bool aimed = false;
+    // nested emitter: a pattern added before, fired along every
+    // direction of this one; the child speeds are offset by the wave
+    // of the parent direction
+    int child = -1;
+};
+
+class BulletPatterns
+{
+    private:
+        struct direction
+        {
+            float dx;
+            float dy;
+            float speed;
+        };
+
+        // phases tables of count directions each, from first
+        struct compiled_pattern
+        {
+            size_t first;
+            Uint32 count;
+            Uint32 phases;
+            bool aimed;
+        };
+
+        // a compiled direction before sin/cos, used while nesting
+        struct polar
+        {
+            float angle;
+            float speed;
+        };
+
+        std::vector<compiled_pattern> m_patterns;
+        std::vector<direction> m_directions;
+        // kept for nesting patterns into later ones
+        std::vector<std::vector<polar>> m_shapes;
+
+    public:
+        components::bullet_pattern_id add(const bullet_pattern& pattern);
+
+        // bullets fired by every shot of pattern
+        const Uint32 get_bullet_count(const components::bullet_pattern_id pattern) const
+        {
+            return m_patterns[pattern].count;
+        }
+
+        /**
+         * Fire the shot number shot of pattern from origin; aim is the
+         * unit vector toward the target, ignored by patterns not aimed
+         */
+        void fire(const components::bullet_pattern_id pattern,
+                  const Uint32 shot,
+                  const components::position origin,
+                  const components::velocity& aim,
+                  const unsigned int collision_mask,
+                  BulletPool& bullets,
+                  entt::registry& registry) const;
+};
+
+#endif
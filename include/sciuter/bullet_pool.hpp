@@ -0,0 +1,108 @@
+/**
+ * Pool of recycled bullet entities.
+ * Bullets are created up front with all their components; spawning one
+ * just removes the components::inactive tag and resets its state from
+ * a prototype (texture, source rect, damage and collision mask resolved
+ * once), despawning it assigns the tag back.
+ * Live bullets are also kept in a BulletStore: update moves them, builds
+ * their rects and parks the ones leaving the boundaries with the SIMD
+ * kernels, then copies position and destination_rect back to the
+ * entities for collisions and rendering. Bullet velocities are fixed at
+ * spawn time.
+ * Systems touching bullets must exclude components::inactive, systems
+ * moving entities must exclude components::bullet_slot.
+ */
+#ifndef __SCIUTER_BULLET_POOL_HPP__
+#define __SCIUTER_BULLET_POOL_HPP__
+
+#include <vector>
+#include <entt/entt.hpp>
+#include <sciuter/sdl.hpp>
+#include <sciuter/bullet_store.hpp>
+#include <sciuter/command_buffer.hpp>
+#include <sciuter/components.hpp>
+
+class BulletPool
+{
+    public:
+        struct prototype
+        {
+            unsigned int collision_mask;
+            SDL_Texture* texture;
+            SDL_Rect source_rect;
+            int damage;
+        };
+
+    private:
+        entt::registry& m_registry;
+        SDL_Rect m_boundaries;
+        size_t m_size = 0;
+        size_t m_grow_size;
+        std::vector<prototype> m_prototypes;
+        BulletStore m_store;
+        // entity of every bullet of the store, at the same index
+        std::vector<entt::entity> m_entities;
+
+        void grow(const size_t count, entt::registry& registry);
+        // nullptr if no prototype was set for collision_mask
+        const prototype* get_prototype(const unsigned int collision_mask) const;
+
+        // bullets parked or destroyed leave the store
+        void on_park(const entt::entity bullet, entt::registry& registry);
+
+    public:
+        BulletPool(entt::registry& registry,
+                   const SDL_Rect& boundaries,
+                   const size_t grow_size=256);
+        ~BulletPool();
+        BulletPool(const BulletPool&) = delete;
+        BulletPool& operator=(const BulletPool&) = delete;
+
+        /**
+         * Register the look and damage of the bullets spawned with
+         * collision_mask, source is the part of texture to draw
+         */
+        void set_prototype(const unsigned int collision_mask,
+                           SDL_Texture* texture,
+                           const SDL_Rect& source,
+                           const int damage);
+
+        // pre-allocate count parked bullets
+        void reserve(const size_t count, entt::registry& registry);
+
+        /**
+         * Make sure count bullets can be acquired without growing, for
+         * bulk spawns
+         */
+        void reserve_parked(const size_t count, entt::registry& registry);
+
+        const size_t size() const { return m_size; }
+        // bullets spawned and not parked yet
+        const size_t get_live_count() const { return m_store.size(); }
+
+        /**
+         * Move the live bullets by dt seconds and release the ones out of
+         * the boundaries
+         */
+        void update(const float dt, CommandBuffer& commands, entt::registry& registry);
+
+        /**
+         * position and velocity are copies: acquiring may grow the pool
+         * and move the position components they could point into.
+         * Returns entt::null, spawning nothing, if no prototype was set
+         * for collision_mask
+         */
+        entt::entity acquire(
+            const components::position position,
+            const components::velocity velocity,
+            const unsigned int collision_mask,
+            entt::registry& registry);
+
+        // park the bullet at the next sync point
+        static void release(const entt::entity bullet, CommandBuffer& commands)
+        {
+            commands.assign<components::inactive>(bullet);
+        }
+};
+
+#endif
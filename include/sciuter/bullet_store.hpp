@@ -0,0 +1,75 @@
+/**
+ * Bullets in structure of arrays layout, for simulations too large for
+ * the per entity systems: update integrates the positions, computes the
+ * screen rects and flags the bullets out of the boundaries in a single
+ * pass, vectorized with AVX2 when the CPU has it, SSE2 otherwise (always
+ * there on x86-64) and a scalar loop elsewhere.
+ * Results match the ECS systems: rects are centered on the position
+ * truncated to int, like center_position does.
+ */
+#ifndef __SCIUTER_BULLET_STORE_HPP__
+#define __SCIUTER_BULLET_STORE_HPP__
+
+#include <vector>
+#include <sciuter/sdl.hpp>
+
+class BulletStore
+{
+    public:
+        enum class kernel
+        {
+            scalar,
+            simd,   // the widest available, scalar if none
+        };
+
+    private:
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_dx;
+        std::vector<float> m_dy;
+        std::vector<float> m_speed;
+        std::vector<Sint32> m_w;
+        std::vector<Sint32> m_h;
+        std::vector<Sint32> m_rect_x;
+        std::vector<Sint32> m_rect_y;
+        // 1 for bullets out of the boundaries after the last update
+        std::vector<Uint8> m_outside;
+
+    public:
+        // returns the index of the bullet, valid until a removal
+        size_t add(const float x, const float y,
+                   const float dx, const float dy, const float speed,
+                   const int w, const int h);
+
+        void reserve(const size_t count);
+        void clear();
+        const size_t size() const { return m_x.size(); }
+
+        /**
+         * Move every bullet by dt seconds, compute its rect and flag it
+         * when the rect doesn't touch boundaries; returns the flagged count
+         */
+        size_t update(const float dt, const SDL_Rect& boundaries,
+                      const kernel use = kernel::simd);
+
+        // the last bullet takes the place of the removed one
+        void remove(const size_t index);
+
+        const float* get_x() const { return m_x.data(); }
+        const float* get_y() const { return m_y.data(); }
+        const Sint32* get_rect_x() const { return m_rect_x.data(); }
+        const Sint32* get_rect_y() const { return m_rect_y.data(); }
+        const Sint32* get_w() const { return m_w.data(); }
+        const Sint32* get_h() const { return m_h.data(); }
+        const Uint8* get_outside() const { return m_outside.data(); }
+
+        SDL_Rect get_rect(const size_t index) const
+        {
+            return {m_rect_x[index], m_rect_y[index], m_w[index], m_h[index]};
+        }
+
+        // name of the kernel update uses for kernel::simd
+        static const char* get_simd_name();
+};
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * Structural changes (entity creation and destruction, component
+ * assignment) requested by systems while they iterate views.
+ * Changes are recorded during the frame and applied in one batch by
+ * flush, at a sync point of the main loop, so that no pool is
+ * reshuffled under a running loop.
+ * Recorded commands come from a memory resource, meant to be the
+ * FrameArena, which must keep them alive until the flush: commands must
+ * not outlive the frame they were recorded in, so the buffer has to be
+ * flushed before the arena is swapped (end_frame does).
+ */
+#ifndef __SCIUTER_COMMAND_BUFFER_HPP__
+#define __SCIUTER_COMMAND_BUFFER_HPP__
+
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <entt/entt.hpp>
+
+class CommandBuffer
+{
+    public:
+        // placeholder for an entity that will be created on flush
+        struct pending_entity
+        {
+            size_t index;
+        };
+
+    private:
+        struct command
+        {
+            command* next = nullptr;
+
+            virtual void apply(entt::registry& registry,
+                               std::vector<entt::entity>& created) = 0;
+            // destroy and give the memory back to where it came from
+            virtual void release(std::pmr::memory_resource* memory) = 0;
+        };
+
+        template<typename Func>
+        struct command_function : command
+        {
+            Func func;
+
+            command_function(Func&& func_) : func(std::move(func_)) {}
+
+            void apply(entt::registry& registry,
+                       std::vector<entt::entity>& created) override
+            {
+                func(registry, created);
+            }
+
+            void release(std::pmr::memory_resource* memory) override
+            {
+                this->~command_function();
+                memory->deallocate(this, sizeof(command_function),
+                                   alignof(command_function));
+            }
+        };
+
+        std::pmr::memory_resource* m_memory;
+        // commands in recording order
+        command* m_first = nullptr;
+        command* m_last = nullptr;
+        std::vector<entt::entity> m_created;
+        std::vector<entt::entity> m_destroyed;
+        size_t m_pending_count = 0;
+
+        template<typename Func>
+        void push(Func&& func)
+        {
+            typedef command_function<std::decay_t<Func>> type;
+            command* recorded = new(m_memory->allocate(sizeof(type), alignof(type)))
+                type(std::move(func));
+
+            if(nullptr == m_last)
+            {
+                m_first = recorded;
+            }
+            else
+            {
+                m_last->next = recorded;
+            }
+            m_last = recorded;
+        }
+
+        // destroy the recorded commands, applied or not
+        void release();
+
+    public:
+        CommandBuffer(std::pmr::memory_resource* memory=std::pmr::get_default_resource())
+            : m_memory(memory) {}
+        ~CommandBuffer() { release(); }
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        pending_entity create()
+        {
+            push([](entt::registry& registry, std::vector<entt::entity>& created) {
+                created.push_back(registry.create());
+            });
+            return {m_pending_count++};
+        }
+
+        /**
+         * Components are assigned or replaced, so assigning the same
+         * component twice in a frame is not an error
+         */
+        template<typename Component, typename... Args>
+        void assign(const entt::entity entity, Args&&... args)
+        {
+            push([entity, args...](entt::registry& registry,
+                                   std::vector<entt::entity>&) {
+                if(registry.valid(entity))
+                {
+                    registry.assign_or_replace<Component>(entity, args...);
+                }
+            });
+        }
+
+        template<typename Component, typename... Args>
+        void assign(const pending_entity entity, Args&&... args)
+        {
+            push([entity, args...](entt::registry& registry,
+                                   std::vector<entt::entity>& created) {
+                registry.assign_or_replace<Component>(
+                    created[entity.index], args...);
+            });
+        }
+
+        /**
+         * Destroying an entity more than once in a frame is allowed,
+         * only the first request has effect
+         */
+        void destroy(const entt::entity entity)
+        {
+            m_destroyed.push_back(entity);
+        }
+
+        const bool empty() const
+        {
+            return nullptr == m_first && m_destroyed.empty();
+        }
+
+        // apply all the recorded changes and clear the buffer
+        void flush(entt::registry& registry);
+};
+
+#endif
@@ -1,12 +1,12 @@
 #ifndef __SCIUTER_COMPONENTS_HPP__
 #define __SCIUTER_COMPONENTS_HPP__
 
-#include <map>
 #include <math.h>
 #include <memory>
 #include <vector>
 #include <entt/entt.hpp>
 #include <sciuter/animation.hpp>
+#include <sciuter/resources.hpp>
 
 namespace components
 {
@@ -17,6 +17,14 @@ namespace components
 	bool global = false;
     };
 
+    // position at the previous simulation tick, used to interpolate
+    // rendering between ticks
+    struct previous_position
+    {
+        float x;
+        float y;
+    };
+
     struct velocity
     {
         float dx;
@@ -35,40 +43,37 @@ namespace components
         }
     };
 
+    // per entity playing state of a shared animation clip, the frames
+    // are owned by Resources
     struct animation
     {
-        int frame_index;
-        float frame_time;
+        animation_clip_id clip;
+        Uint32 frame_index;
         float next_frame_time;
-        Animation animation_data;
-        float speed;
 
-        animation(const Animation& _animation, const float _speed)
-            : frame_index(0), animation_data(_animation), speed(_speed)
-        {
-            frame_time = _speed / _animation.get_frame_count();
-            next_frame_time = frame_time;
-        }
+        animation(const animation_clip_id _clip)
+            : clip(_clip), frame_index(0),
+              next_frame_time(Resources::get_animation_clip(_clip).frame_time) {}
 
-        void update(float dt)
+        void update(float dt, const animation_clip& data)
         {
             next_frame_time -= dt;
 
             if(next_frame_time <= 0.f)
             {
                 frame_index += 1;
-                if(frame_index >= animation_data.get_frame_count())
+                if(frame_index >= (Uint32)data.animation->get_frame_count())
                 {
                     frame_index = 0;
                 }
-                next_frame_time += frame_time;
+                next_frame_time += data.frame_time;
             }
         }
 
-        const SDL_Rect& get_current_frame()
+        const SDL_Rect& get_current_frame(const animation_clip& data) const
         {
-            return animation_data.get_frames()[frame_index];
-        };
+            return data.animation->get_frames()[frame_index];
+        }
     };
 
     struct source_rect
@@ -87,71 +92,87 @@ namespace components
 
     using destination_rect = SDL_Rect;
 
-    struct screen_boundaries
+    struct image
     {
-        SDL_Rect rect;
+        SDL_Texture* texture;
     };
 
-    struct image
+    // high level actions triggered by the player, each one is a bit
+    // of an ActionStatus
+    enum class action : Uint8
     {
-        SDL_Texture* texture;
+        move_left,
+        move_right,
+        move_up,
+        move_down,
+        fire
     };
 
-    typedef std::map<Uint8, std::string> KeyActionMap;
-    typedef std::map<std::string, Uint8> ActionStatusMap;
+    typedef Uint32 ActionStatus;
+
+    struct key_binding
+    {
+        SDL_Scancode key;
+        action value;
+    };
+
+    typedef std::vector<key_binding> KeyActionMap;
 
     struct gamepad
     {
         KeyActionMap key_action_mapping;
-        ActionStatusMap previous_status;
-        ActionStatusMap current_status;
+        ActionStatus previous_status = 0;
+        ActionStatus current_status = 0;
 
         gamepad(const KeyActionMap& _key_action_mapping)
-            : key_action_mapping(_key_action_mapping)
+            : key_action_mapping(_key_action_mapping) {}
+
+        static constexpr ActionStatus bit(const action value)
         {
-            for(auto& [_key, val] : _key_action_mapping)
-            {
-                previous_status[val] = 0;
-                current_status[val] = 0;
-            }
+            return 1u << static_cast<Uint8>(value);
         }
 
-        void update()
+        // keys as returned by SDL_GetKeyboardState, indexed by scancode
+        ActionStatus read_keyboard(const Uint8* keys) const
         {
-            SDL_PumpEvents();
-            const Uint8* keys = SDL_GetKeyboardState(NULL);
-            // keep track of previos status
-            for(auto& [key, val] : current_status)
-            {
-                previous_status[key] = val;
-            }
+            ActionStatus status = 0;
 
-            for(auto& [key, val] : key_action_mapping)
+            // more keys bound to the same action are or-ed together
+            for(auto& binding : key_action_mapping)
             {
-                current_status[val] = keys[key];
+                if(keys[binding.key])
+                {
+                    status |= bit(binding.value);
+                }
             }
+            return status;
         }
 
-        bool down(const std::string& action)
+        // keep track of previous status and replace the current one
+        void set_status(const ActionStatus status)
         {
-            return current_status[action] == 1;
+            previous_status = current_status;
+            current_status = status;
         }
 
-        bool up(const std::string& action)
+        bool down(const action value) const
         {
-            return current_status[action] == 1;
+            return (current_status & bit(value)) != 0;
         }
 
-        bool pressed(const std::string& action)
+        bool up(const action value) const
         {
-            return (current_status[action] == 1 &&
-                    previous_status[action] == 0);
+            return (current_status & bit(value)) == 0;
         }
 
-        bool released(const std::string& action)
+        bool pressed(const action value) const
         {
-            return (current_status[action] == 0 &&
-                    previous_status[action] == 1);
+            return (current_status & ~previous_status & bit(value)) != 0;
+        }
+
+        bool released(const action value) const
+        {
+            return (~current_status & previous_status & bit(value)) != 0;
         }
     };
 
@@ -175,39 +196,49 @@ namespace components
 	entt::entity entity;
     };
 
+    typedef Uint32 bullet_pattern_id;
+
+    // periodic timer run by the TimerWheel, timed_out only in the ticks
+    // it expires in
     struct timer
     {
-	float timeout;
-	float reset_time;
-
-	timer(const float time) : timeout(time), reset_time(time) {}
-	timer(const float time, const float start_offset)
-	    : timeout(time * start_offset), reset_time(time) {}
-
-	const float update(const float dt) {
-	    if(timeout <= 0.f) {
-		timeout += reset_time;
-	    }
-	    timeout -= dt;
-	    return timeout;
-	}
-
-	const bool timed_out() const { return timeout <= 0.f; }
+	float period;
+	// first expiration after start_offset periods
+	float start_offset = 1.f;
+	bool fired = false;
+	// node in the TimerWheel
+	Uint32 handle = 0xffffffff;
+
+	timer(const float time) : period(time) {}
+	timer(const float time, const float start_offset_)
+	    : period(time), start_offset(start_offset_) {}
+
+	const bool timed_out() const { return fired; }
     };
 
     struct world_position {};
 
-    using draw_order = int;
+    // tag of the bullets parked in the BulletPool, skipped by the systems
+    struct inactive {};
 
-    class IEntityBehavior {
-    public:
-	virtual ~IEntityBehavior() = default;
-	virtual const bool has_finished() const = 0;
-	virtual void update(const float dt, entt::entity &entity,
-			    entt::registry &registry) = 0;
+    // every bullet of a BulletPool, the index of a live one in the pool
+    // BulletStore; the store moves them, the per entity systems skip them
+    struct bullet_slot
+    {
+        static constexpr Uint32 NONE = 0xffffffff;
+
+        Uint32 index = NONE;
     };
 
-    typedef std::shared_ptr<IEntityBehavior> entity_behavior;
+    // tag of the world entities out of the camera view, not drawn,
+    // animated or collided until they come back in view
+    struct culled {};
+
+    // tag of the entities spawned by the LevelStreamer, destroyed once
+    // the camera left them behind
+    struct streamed {};
+
+    using draw_order = int;
 
     // trying to have an high level concept of transformation
     // that can be applied to an entity
@@ -0,0 +1,78 @@
+/**
+ * Scratch memory for data living at most two frames, as a
+ * std::pmr::memory_resource so containers and CommandBuffer can use it.
+ * Allocating bumps an atomic offset in the block of the current frame,
+ * deallocating does nothing; swap at the end of the frame switches to
+ * the other block and rewinds it in O(1). The block being left stays
+ * untouched for one more frame, so the render can still read what the
+ * simulation built in the previous frame.
+ * Allocations that don't fit the block go to the upstream resource and
+ * are released by the rewind, which then grows the block to the peak
+ * use, so after a few frames nothing reaches the heap anymore.
+ */
+#ifndef __SCIUTER_FRAME_ARENA_HPP__
+#define __SCIUTER_FRAME_ARENA_HPP__
+
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+class FrameArena : public std::pmr::memory_resource
+{
+    private:
+        struct overflow
+        {
+            void* memory;
+            size_t bytes;
+            size_t alignment;
+        };
+
+        struct buffer
+        {
+            std::unique_ptr<char[]> memory;
+            size_t capacity = 0;
+            std::atomic<size_t> offset{0};
+            // bytes requested during the frame, blocks included
+            std::atomic<size_t> requested{0};
+            std::atomic<size_t> allocations{0};
+            std::vector<overflow> overflows;
+        };
+
+        std::pmr::memory_resource* m_upstream;
+        buffer m_buffers[2];
+        buffer* m_current;
+        // guards the overflow lists, the bump path is lock free
+        std::mutex m_overflow_mutex;
+
+        void rewind(buffer& target);
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    public:
+        FrameArena(const size_t capacity=1 << 20,
+                   std::pmr::memory_resource* upstream=std::pmr::new_delete_resource());
+        ~FrameArena();
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        /**
+         * End of frame: memory allocated two frames ago is reclaimed,
+         * memory of the frame just ended stays valid until the next swap
+         */
+        void swap();
+
+        // allocator calls and bytes of the current frame
+        const size_t get_allocations() const { return m_current->allocations; }
+        const size_t get_bytes() const { return m_current->requested; }
+        const size_t get_capacity() const { return m_current->capacity; }
+};
+
+#endif
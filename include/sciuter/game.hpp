@@ -1,8 +1,152 @@
 #ifndef __SCIUTER_GAME_HPP__
 #define __SCIUTER_GAME_HPP__
 
+#include <memory>
+#include <string>
+#include <vector>
+#include <entt/entt.hpp>
 #include <sciuter/sdl.hpp>
+#include <sciuter/bullet_patterns.hpp>
+#include <sciuter/bullet_pool.hpp>
+#include <sciuter/command_buffer.hpp>
+#include <sciuter/frame_arena.hpp>
+#include <sciuter/input_recording.hpp>
+#include <sciuter/level_streamer.hpp>
+#include <sciuter/render_order.hpp>
+#include <sciuter/scripts.hpp>
+#include <sciuter/spatial_grid.hpp>
+#include <sciuter/sprite_batch.hpp>
+#include <sciuter/system_scheduler.hpp>
+#include <sciuter/timer_wheel.hpp>
+#include <sciuter/work_stealing_pool.hpp>
 
-void main_loop(SDL_Window* window, const int scale);
+// game dimension constants, the native resolution of the scene
+const int AREA_WIDTH = 640;
+const int AREA_HEIGHT = 480;
+
+/**
+ * Everything needed to simulate and draw a level, shared by the
+ * interactive main loop and the headless driver
+ */
+struct GameState
+{
+    entt::registry registry;
+    RenderOrder render_order;
+    TimerWheel timers;
+    SDL_Rect screen_rect;
+    SpatialGrid collision_grid;
+    // scratch memory of the frame, swapped at the end of every frame
+    FrameArena frame_arena;
+    CommandBuffer commands;
+    BulletPool bullets;
+    BulletPatterns patterns;
+    ScriptScheduler scripts;
+    SpriteBatch batch;
+    InputRecording input;
+    // keyboard state of the tick, taken by update_simulation
+    std::vector<Uint8> keyboard;
+    LevelStreamer level;
+    entt::entity player;
+    entt::entity camera;
+    SystemScheduler systems;
+    // runs the independent systems concurrently, none for a single thread
+    std::unique_ptr<WorkStealingPool> workers;
+
+    // zero threads means one per hardware thread
+    GameState(const SDL_Rect& screen, const size_t threads=1);
+};
+
+/**
+ * Accumulated run time of each system called by update_simulation,
+ * in performance counter ticks and in call order
+ */
+class SystemTimings
+{
+    public:
+        struct system
+        {
+            const char* name;
+            Uint64 counter_ticks;
+        };
+
+    private:
+        std::vector<system> m_systems;
+        size_t m_next = 0;
+
+    public:
+        void begin_tick() { m_next = 0; }
+        void add(const char* name, const Uint64 counter_ticks);
+        const std::vector<system>& get_systems() const { return m_systems; }
+};
+
+/**
+ * Record the input of a run to a file or replay one, empty paths
+ * disable them; a replay brings its own seed and tick rate
+ */
+struct InputOptions
+{
+    std::string record_path;
+    std::string replay_path;
+};
+
+struct HeadlessOptions
+{
+    unsigned int seed = 0;
+    // zero runs a replay to its end
+    int ticks = 3600;
+    int tick_rate = 60;
+    // draw every tick with the software renderer, otherwise only the
+    // simulation runs
+    bool render = false;
+    size_t threads = 1;
+    InputOptions input;
+};
+
+void load_resources(SDL_Renderer* renderer);
+
+// create the entities of the level, seed drives the random placements
+void create_scene(const unsigned int seed, GameState& state);
+
+/**
+ * Prepare recording or replaying the input as asked by options; a replay
+ * replaces seed and tick_rate with the recorded ones. False if the
+ * replay can't be loaded
+ */
+bool start_input(const InputOptions& options,
+                 unsigned int& seed,
+                 int& tick_rate,
+                 GameState& state);
+
+// save the recorded input, if any
+bool finish_input(const InputOptions& options, const GameState& state);
+
+// advance the simulation by one fixed tick
+void update_simulation(const float dt,
+                       GameState& state,
+                       SystemTimings* timings=nullptr);
+
+// rebuild destination rects interpolating alpha between the last two ticks
+void update_render_rects(const float alpha, GameState& state);
+
+// flush the pending commands, report the frame arena use to the
+// profiler and swap it
+void end_frame(GameState& state);
+
+/**
+ * The scene is drawn at its native resolution into a target texture,
+ * stretched to the whole window with a nearest neighbour copy; the
+ * window should be an integer multiple of the scene size.
+ * tick_rate is the number of fixed simulation steps per second
+ */
+void main_loop(SDL_Window* window, const int tick_rate=60,
+               const size_t threads=1,
+               const InputOptions& input=InputOptions());
+
+/**
+ * Run the simulation without a window as fast as possible and report
+ * ticks per second and time spent in each system; returns the process
+ * exit code
+ */
+int run_headless(const HeadlessOptions& options);
 
 #endif
@@ -0,0 +1,76 @@
+/**
+ * Record and replay of the player input: the seed of the level and the
+ * ActionStatus of every gamepad at every tick, run length encoded since
+ * input changes far less often than ticks. With a fixed tick time a
+ * replay drives the simulation through the very same states.
+ *
+ * File layout, native endianness: recording_header, then run_count
+ * status_run.
+ */
+#ifndef __SCIUTER_INPUT_RECORDING_HPP__
+#define __SCIUTER_INPUT_RECORDING_HPP__
+
+#include <string>
+#include <vector>
+#include <sciuter/components.hpp>
+
+const char RECORDING_MAGIC[4] = {'S', 'C', 'I', 'N'};
+const Uint32 RECORDING_VERSION = 1;
+
+struct recording_header
+{
+    char magic[4];
+    Uint32 version;
+    Uint32 seed;
+    Uint32 tick_rate;
+    // statuses recorded, one per gamepad per tick
+    Uint32 status_count;
+    Uint32 run_count;
+};
+
+struct status_run
+{
+    components::ActionStatus status;
+    Uint32 count;
+};
+
+class InputRecording
+{
+    public:
+        enum class mode
+        {
+            live,
+            record,
+            replay,
+        };
+
+    private:
+        mode m_mode = mode::live;
+        Uint32 m_seed = 0;
+        Uint32 m_tick_rate = 0;
+        Uint32 m_status_count = 0;
+        std::vector<status_run> m_runs;
+        // replay position
+        Uint32 m_position = 0;
+        size_t m_run = 0;
+        Uint32 m_run_offset = 0;
+
+    public:
+        void start_recording(const Uint32 seed, const Uint32 tick_rate);
+        void push(const components::ActionStatus status);
+        bool save(const std::string& path) const;
+
+        // load a recording and start replaying it, false if unreadable
+        bool load(const std::string& path);
+
+        // next recorded status, no action pressed past the end
+        components::ActionStatus next();
+        const bool finished() const { return m_position >= m_status_count; }
+
+        const mode get_mode() const { return m_mode; }
+        const Uint32 get_seed() const { return m_seed; }
+        const Uint32 get_tick_rate() const { return m_tick_rate; }
+        const Uint32 get_status_count() const { return m_status_count; }
+};
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * Spawns the enemies of a level as the camera gets close to them instead
+ * of all at load time, and destroys them once the camera left them
+ * behind, so that the live entities stay bounded however long the
+ * level is.
+ * The level is a compact array of spawn records sorted by world y; the
+ * camera scrolls towards smaller y, so the records are consumed in
+ * decreasing y order by a single cursor and each spawns at most once.
+ */
+#ifndef __SCIUTER_LEVEL_STREAMER_HPP__
+#define __SCIUTER_LEVEL_STREAMER_HPP__
+
+#include <vector>
+#include <entt/entt.hpp>
+#include <sciuter/command_buffer.hpp>
+#include <sciuter/components.hpp>
+
+// creates the entity of a spawn record at the given world position
+typedef entt::entity (*spawn_function)(const float x, const float y,
+                                       entt::registry& registry);
+
+struct spawn_record
+{
+    float x;
+    float y;
+    Uint32 kind;
+};
+
+class LevelStreamer
+{
+    private:
+        std::vector<spawn_function> m_kinds;
+        std::vector<spawn_record> m_records;
+        size_t m_next = 0;
+        bool m_sorted = true;
+        float m_lookahead;
+        float m_despawn_distance;
+
+    public:
+        /**
+         * Records spawn when the top of the camera view is closer than
+         * lookahead, entities are destroyed when they are farther than
+         * despawn_distance below its bottom
+         */
+        LevelStreamer(const float lookahead=128.f,
+                      const float despawn_distance=128.f)
+            : m_lookahead(lookahead), m_despawn_distance(despawn_distance) {}
+
+        Uint32 add_kind(const spawn_function spawn);
+        void add(const Uint32 kind, const float x, const float y);
+
+        /**
+         * Spawn the records coming in range of the camera view and queue
+         * the destruction of the streamed entities left behind
+         */
+        void update(const components::position& camera,
+                    const SDL_Rect& viewport,
+                    CommandBuffer& commands,
+                    entt::registry& registry);
+
+        // records not spawned yet
+        const size_t get_pending() const { return m_records.size() - m_next; }
+};
+
+#endif
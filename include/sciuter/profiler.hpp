@@ -0,0 +1,108 @@
+/**
+ * Low overhead frame profiler.
+ * SCIUTER_PROFILE_ZONE("name") times the enclosing scope and records it
+ * in a lock-free ring buffer keeping the most recent zones, which can
+ * be saved in the Chrome trace event format (chrome://tracing, Perfetto).
+ * Zones are compiled in only when SCIUTER_PROFILER is defined (cmake
+ * -DSCIUTER_PROFILER=ON), otherwise the macro expands to nothing.
+ * SCIUTER_PROFILE_COUNTER("name", value) samples a value, drawn as a
+ * counter track in the trace.
+ * Zone and counter names must be string literals, only the pointer is
+ * stored.
+ */
+#ifndef __SCIUTER_PROFILER_HPP__
+#define __SCIUTER_PROFILER_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sciuter/sdl.hpp>
+
+class Profiler
+{
+    public:
+        struct zone_event
+        {
+            const char* name;
+            Uint64 start;
+            // counter samples have no duration, they store the value here
+            Uint64 end;
+            uint32_t thread;
+            bool counter;
+        };
+
+        // number of zones kept, older ones get overwritten
+        static const size_t CAPACITY = 1 << 16;
+
+    private:
+        // sequence is 0 while the event is being written, otherwise the
+        // index of the event plus one; readers skip slots that change
+        // while they copy them
+        struct slot
+        {
+            std::atomic<uint64_t> sequence;
+            zone_event event;
+        };
+
+        std::unique_ptr<slot[]> m_slots;
+        std::atomic<uint64_t> m_head;
+
+        static Profiler s_instance;
+
+        Profiler();
+
+        void _record(const char* name, const Uint64 start, const Uint64 end,
+                     const bool counter);
+        bool _write_chrome_trace(const std::string& path) const;
+
+    public:
+        static const bool enabled();
+
+        static void record(const char* name, const Uint64 start, const Uint64 end)
+        {
+            s_instance._record(name, start, end, false);
+        }
+
+        static void record_counter(const char* name, const Uint64 value)
+        {
+            s_instance._record(name, SDL_GetPerformanceCounter(), value, true);
+        }
+
+        static bool write_chrome_trace(const std::string& path)
+        {
+            return s_instance._write_chrome_trace(path);
+        }
+};
+
+class ProfileZone
+{
+    private:
+        const char* m_name;
+        Uint64 m_start;
+
+    public:
+        explicit ProfileZone(const char* name)
+            : m_name(name), m_start(SDL_GetPerformanceCounter()) {}
+
+        ~ProfileZone()
+        {
+            Profiler::record(m_name, m_start, SDL_GetPerformanceCounter());
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+#ifdef SCIUTER_PROFILER
+#define SCIUTER_PROFILE_CONCAT_(a, b) a##b
+#define SCIUTER_PROFILE_CONCAT(a, b) SCIUTER_PROFILE_CONCAT_(a, b)
+#define SCIUTER_PROFILE_ZONE(name) \
+    ProfileZone SCIUTER_PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#define SCIUTER_PROFILE_COUNTER(name, value) Profiler::record_counter(name, value)
+#else
+#define SCIUTER_PROFILE_ZONE(name)
+#define SCIUTER_PROFILE_COUNTER(name, value)
+#endif
+
+#endif
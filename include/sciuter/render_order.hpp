@@ -0,0 +1,58 @@
+/**
+ * Keeps the entities drawn by render_sprites sorted by draw order (and
+ * by texture inside a layer, for batching) without sorting every frame.
+ * Registry signals mark the order as dirty when an entity enters or
+ * leaves the render group or changes layer or texture; sort then does
+ * nothing on clean frames, an insertion fix-up after a few changes and
+ * a counting sort on (draw order, texture) after many changes.
+ * Components written in place through registry.get bypass the signals:
+ * call invalidate after changing draw_order or image that way.
+ */
+#ifndef __SCIUTER_RENDER_ORDER_HPP__
+#define __SCIUTER_RENDER_ORDER_HPP__
+
+#include <vector>
+#include <entt/entt.hpp>
+#include <sciuter/components.hpp>
+
+// the entities drawn by render_sprites, a single definition shared by
+// everybody iterating or sorting them
+inline auto render_group(entt::registry& registry)
+{
+    return registry.group<
+	components::draw_order,
+        components::image,
+        components::source_rect,
+        components::destination_rect>(entt::exclude<components::inactive,
+                                                     components::culled>);
+}
+
+class RenderOrder
+{
+    private:
+        entt::registry& m_registry;
+        size_t m_changes;
+        // scratch buffers of the counting sort, kept across frames
+        std::vector<SDL_Texture*> m_textures;
+        std::vector<unsigned int> m_bucket_start;
+        std::vector<entt::entity> m_sorted;
+
+        void counting_sort();
+
+    public:
+        // above this many changes a full counting sort is cheaper
+        static const size_t INCREMENTAL_LIMIT = 32;
+
+        RenderOrder(entt::registry& registry);
+        ~RenderOrder();
+        RenderOrder(const RenderOrder&) = delete;
+        RenderOrder& operator=(const RenderOrder&) = delete;
+
+        void invalidate() { m_changes += 1; }
+        // force a full sort on the next call to sort
+        void invalidate_all() { m_changes = INCREMENTAL_LIMIT + 1; }
+
+        void sort();
+};
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * Loads resources in parallel: image decoding and animation parsing run
+ * on the workers of a WorkStealingPool, only the texture upload, which needs
+ * the renderer, runs on the calling (render) thread in poll or finish.
+ * Every request returns a future that becomes ready once the resource
+ * is stored in Resources.
+ * Small textures can be packed into shared atlas pages, so that sprites
+ * drawn with them don't switch texture.
+ */
+#ifndef __SCIUTER_RESOURCE_LOADER_HPP__
+#define __SCIUTER_RESOURCE_LOADER_HPP__
+
+#include <future>
+#include <string>
+#include <vector>
+#include <sciuter/asset_pack.hpp>
+#include <sciuter/resources.hpp>
+#include <sciuter/work_stealing_pool.hpp>
+
+typedef std::shared_future<entt::handle<texture_resource>> texture_future;
+typedef std::shared_future<entt::handle<animation_resource>> animation_future;
+
+class ResourceLoader
+{
+    private:
+        struct pending_texture
+        {
+            texture_id_type id;
+            std::string path;
+            std::future<SDL_Surface*> surface;
+            std::promise<entt::handle<texture_resource>> ready;
+        };
+
+        struct pending_animations
+        {
+            animation_id_type id;
+            std::future<AnimationMap> animations;
+            std::promise<entt::handle<animation_resource>> ready;
+        };
+
+        // a decoded texture waiting for its place in an atlas page
+        struct atlas_sprite
+        {
+            texture_id_type id;
+            std::string path;
+            SDL_Surface* surface;
+            std::promise<entt::handle<texture_resource>> ready;
+        };
+
+        WorkStealingPool& m_pool;
+        std::vector<pending_texture> m_textures;
+        std::vector<pending_animations> m_animations;
+        std::vector<atlas_sprite> m_atlas_sprites;
+        int m_atlas_sprite_size = 0;
+        int m_atlas_page_size = 0;
+
+        // upload surface or keep it for the atlas
+        void store_texture(pending_texture& pending, SDL_Surface* surface,
+                           SDL_Renderer* renderer);
+        void pack_atlas(SDL_Renderer* renderer);
+
+    public:
+        ResourceLoader(WorkStealingPool& pool) : m_pool(pool) {}
+
+        texture_future load_texture(texture_id_type id, const std::string path);
+        animation_future load_animations(animation_id_type id, const std::string path);
+
+        /**
+         * Same as above but decoding the pack entry with that id, the
+         * pack must stay open until the loader is finished
+         */
+        texture_future load_texture(texture_id_type id, const AssetPack& pack);
+        animation_future load_animations(animation_id_type id, const AssetPack& pack);
+
+        // request every asset of pack under its own id
+        void load_pack(const AssetPack& pack);
+
+        /**
+         * Textures up to max_size pixels per side are packed in atlas
+         * pages page_size pixels wide, once all the textures are decoded;
+         * their ids refer to atlas regions (see texture_resource)
+         */
+        void pack_small_textures(const int max_size, const int page_size = 512);
+
+        /**
+         * Store the resources decoded so far without blocking, returns
+         * true when nothing is left pending
+         */
+        bool poll(SDL_Renderer* renderer);
+
+        // block until every requested resource is stored
+        void finish(SDL_Renderer* renderer);
+};
+
+#endif
@@ -3,28 +3,56 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <entt/entt.hpp>
 #include <sciuter/sdl.hpp>
 #include <sciuter/animation.hpp>
 
+/**
+ * A texture or a region of an atlas texture: value is the texture to
+ * draw with and rect the part of it holding the image; atlas regions
+ * don't own their texture
+ */
 struct texture_resource
 {
     SDL_Texture* value;
-    ~texture_resource() { if(nullptr != value) SDL_DestroyTexture(value); }
+    SDL_Rect rect;
+    bool owner = true;
+    ~texture_resource() { if(owner && nullptr != value) SDL_DestroyTexture(value); }
 };
 
 struct texture_loader: entt::loader<texture_loader, texture_resource> {
     std::shared_ptr<texture_resource> load(const std::string path, SDL_Renderer* renderer) const {
 	auto texture = load_texture(path, renderer);
-	return std::shared_ptr<texture_resource>(new texture_resource{texture});
+	return std::shared_ptr<texture_resource>(
+	    new texture_resource{texture, texture_rect(texture)});
+    }
+};
+// for textures decoded elsewhere, for example on a worker thread
+struct texture_surface_loader: entt::loader<texture_surface_loader, texture_resource> {
+    std::shared_ptr<texture_resource> load(SDL_Surface* surface,
+					   const std::string path,
+					   SDL_Renderer* renderer) const {
+	auto texture = create_texture(surface, path, renderer);
+	return std::shared_ptr<texture_resource>(
+	    new texture_resource{texture, texture_rect(texture)});
     }
 };
+// rect of an atlas texture, the atlas must outlive the region
+struct texture_region_loader: entt::loader<texture_region_loader, texture_resource> {
+    std::shared_ptr<texture_resource> load(SDL_Texture* atlas,
+					   const SDL_Rect& rect) const {
+	return std::shared_ptr<texture_resource>(
+	    new texture_resource{atlas, rect, false});
+    }
+};
+
 using texture_cache = entt::cache<texture_resource>;
 using texture_id_type = texture_cache::id_type;
 
 struct animation_resource
 {
-    const AnimationMap value;
+    AnimationMap value;
 };
 
 using animation_cache = entt::cache<animation_resource>;
@@ -37,6 +65,27 @@ struct animation_loader final: entt::loader<animation_loader, animation_resource
     }
 };
 
+/**
+ * An animation of a loaded AnimationMap played at a given speed, shared
+ * by every entity playing it; the animation is owned by the animation
+ * cache and must stay loaded while clips refer to it
+ */
+struct animation_clip
+{
+    const Animation* animation;
+    float frame_time;
+};
+
+typedef Uint32 animation_clip_id;
+
+// for animations parsed elsewhere, for example on a worker thread
+struct animation_map_loader final: entt::loader<animation_map_loader, animation_resource> {
+    std::shared_ptr<animation_resource> load(AnimationMap& animations) const {
+	return std::shared_ptr<animation_resource>(
+	    new animation_resource{ std::move(animations) });
+    }
+};
+
 typedef std::map<std::string, SDL_Texture*> ResourceMap;
 
 /**
@@ -49,6 +98,7 @@ private:
     ResourceMap m_resources{};
     animation_cache animations_{};
     texture_cache textures_{};
+    std::vector<animation_clip> clips_{};
 
     static Resources s_instance;
 
@@ -68,6 +118,30 @@ private:
 	return textures_.load<texture_loader>(id, path, renderer);
     }
 
+    const entt::handle<texture_resource> _add_texture(
+	texture_id_type id,
+	SDL_Surface* surface,
+	const std::string path,
+	SDL_Renderer* renderer) {
+	return textures_.load<texture_surface_loader>(id, surface, path, renderer);
+    }
+
+    const entt::handle<texture_resource> _add_texture_region(
+	texture_id_type id,
+	texture_id_type atlas_id,
+	const SDL_Rect& rect) {
+	return textures_.load<texture_region_loader>(
+	    id, textures_.handle(atlas_id)->value, rect);
+    }
+
+    void _bind_animations(animation_id_type animations_id,
+			  texture_id_type texture_id) {
+	const SDL_Rect& region = textures_.handle(texture_id)->rect;
+	for(auto& [_name, animation] : animations_.handle(animations_id)->value) {
+	    animation.offset(region.x, region.y);
+	}
+    }
+
     const entt::handle<texture_resource> _get_texture(texture_id_type id) const {
 	return textures_.handle(id);
     }
@@ -84,6 +158,28 @@ private:
     const entt::handle<animation_resource> _get_animations(animation_id_type id) const {
 	return animations_.handle(id);
     }
+
+    const entt::handle<animation_resource> _add_animations(animation_id_type id,
+							   AnimationMap& animations) {
+	return animations_.load<animation_map_loader>(id, animations);
+    }
+
+    animation_clip_id _make_animation_clip(animation_id_type id,
+					   const std::string& name,
+					   const float speed) {
+	const Animation* animation = &animations_.handle(id)->value.at(name);
+	const float frame_time = speed / animation->get_frame_count();
+
+	// a handful of clips, a linear scan is enough to share them
+	for(animation_clip_id clip = 0; clip < clips_.size(); ++clip) {
+	    if(clips_[clip].animation == animation &&
+	       clips_[clip].frame_time == frame_time) {
+		return clip;
+	    }
+	}
+	clips_.push_back({animation, frame_time});
+	return clips_.size() - 1;
+    }
 public:
 
     ~Resources() {
@@ -108,6 +204,27 @@ public:
 	return s_instance._get_animations(id);
     }
 
+    // store already parsed animations, the map is moved into the cache
+    static const entt::handle<animation_resource> add_animations(
+	animation_id_type id,
+	AnimationMap& animations) {
+	return s_instance._add_animations(id, animations);
+    }
+
+    /**
+     * Return the clip playing animation name of the animations loaded
+     * with id, in speed seconds; the clip is created on first request
+     */
+    static animation_clip_id make_animation_clip(animation_id_type id,
+						 const std::string& name,
+						 const float speed) {
+	return s_instance._make_animation_clip(id, name, speed);
+    }
+
+    static const animation_clip& get_animation_clip(animation_clip_id clip) {
+	return s_instance.clips_[clip];
+    }
+
     static const entt::handle<texture_resource> load_texture(
 	const std::string path,
 	SDL_Renderer* renderer) {
@@ -121,6 +238,33 @@ public:
 	return s_instance._load_texture(id, path, renderer);
     }
 
+    // upload an already decoded surface, the surface is freed
+    static const entt::handle<texture_resource> add_texture(
+	texture_id_type id,
+	SDL_Surface* surface,
+	const std::string path,
+	SDL_Renderer* renderer) {
+	return s_instance._add_texture(id, surface, path, renderer);
+    }
+
+    // store rect of the atlas texture atlas_id as the texture id
+    static const entt::handle<texture_resource> add_texture_region(
+	texture_id_type id,
+	texture_id_type atlas_id,
+	const SDL_Rect& rect) {
+	return s_instance._add_texture_region(id, atlas_id, rect);
+    }
+
+    /**
+     * Animation frames are rects of the texture they were made for: move
+     * the frames of animations_id to where texture_id sits in its atlas.
+     * Call it once, before creating clips of those animations
+     */
+    static void bind_animations(animation_id_type animations_id,
+				texture_id_type texture_id) {
+	s_instance._bind_animations(animations_id, texture_id);
+    }
+
     static const entt::handle<texture_resource> get_texture(
 	texture_id_type id) {
 	return s_instance._get_texture(id);
@@ -0,0 +1,237 @@
+/**
+ * Scripted behaviors as C++20 coroutines: a script is a function that
+ * co_awaits actions (scripts::wait, scripts::move_to, scripts::fire)
+ * instead of a state machine updated every frame.
+ * A suspended script is a single event in the ScriptScheduler queue,
+ * ordered by the time it has to resume at, so a frame only costs the
+ * scripts that wake up in it however many are waiting. Coroutine frames
+ * come from the ScriptFramePool.
+ */
+#ifndef __SCIUTER_SCRIPTS_HPP__
+#define __SCIUTER_SCRIPTS_HPP__
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+#include <entt/entt.hpp>
+#include <sciuter/bullet_patterns.hpp>
+#include <sciuter/bullet_pool.hpp>
+#include <sciuter/components.hpp>
+
+class ScriptScheduler;
+
+/**
+ * Fixed size blocks for the coroutine frames, carved from chunks and
+ * recycled through a free list, so starting a script doesn't allocate
+ * once the pool is warm; bigger frames fall back to operator new.
+ * Not thread safe: scripts are started and run by one thread at a time.
+ */
+class ScriptFramePool
+{
+    public:
+        static const size_t BLOCK_SIZE = 256;
+        static const size_t BLOCKS_PER_CHUNK = 128;
+
+    private:
+        struct block
+        {
+            block* next;
+        };
+
+        static ScriptFramePool s_instance;
+
+        std::vector<std::unique_ptr<char[]>> m_chunks;
+        block* m_free = nullptr;
+        size_t m_used = 0;
+
+        void* _allocate(const size_t size);
+        void _deallocate(void* frame, const size_t size);
+
+    public:
+        static void* allocate(const size_t size) {
+            return s_instance._allocate(size);
+        }
+
+        static void deallocate(void* frame, const size_t size) {
+            s_instance._deallocate(frame, size);
+        }
+
+        // frames currently allocated from the blocks
+        static const size_t get_used() { return s_instance.m_used; }
+};
+
+/**
+ * Return type of the script coroutines; a script does nothing until it
+ * is handed to ScriptScheduler::start
+ */
+class script
+{
+    public:
+        struct promise_type
+        {
+            entt::entity entity = entt::null;
+            ScriptScheduler* scheduler = nullptr;
+            // shots fired, the phase of spiral patterns
+            Uint32 shot = 0;
+
+            static void* operator new(const size_t size) {
+                return ScriptFramePool::allocate(size);
+            }
+
+            static void operator delete(void* frame, const size_t size) {
+                ScriptFramePool::deallocate(frame, size);
+            }
+
+            script get_return_object() {
+                return script(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+
+        typedef std::coroutine_handle<promise_type> handle;
+
+    private:
+        handle m_handle;
+
+    public:
+        explicit script(handle coroutine) : m_handle(coroutine) {}
+        script(script&& other) noexcept
+            : m_handle(std::exchange(other.m_handle, {})) {}
+        script(const script&) = delete;
+        script& operator=(const script&) = delete;
+        ~script() { if(m_handle) m_handle.destroy(); }
+
+        // hand the coroutine over to who is going to resume it
+        handle release() { return std::exchange(m_handle, {}); }
+};
+
+class ScriptScheduler
+{
+    private:
+        struct event
+        {
+            double time;
+            // events due at the same time resume in scheduling order
+            Uint64 sequence;
+            script::handle coroutine;
+        };
+
+        struct later
+        {
+            bool operator()(const event& a, const event& b) const
+            {
+                if(a.time != b.time) return a.time > b.time;
+                return a.sequence > b.sequence;
+            }
+        };
+
+        std::priority_queue<event, std::vector<event>, later> m_events;
+        double m_time = 0.0;
+        Uint64 m_sequence = 0;
+        const BulletPatterns& m_patterns;
+        BulletPool& m_bullets;
+        entt::registry& m_registry;
+
+    public:
+        ScriptScheduler(const BulletPatterns& patterns,
+                        BulletPool& bullets,
+                        entt::registry& registry)
+            : m_patterns(patterns), m_bullets(bullets), m_registry(registry) {}
+        ~ScriptScheduler();
+        ScriptScheduler(const ScriptScheduler&) = delete;
+        ScriptScheduler& operator=(const ScriptScheduler&) = delete;
+
+        // run script on entity, starting from the next update
+        void start(const entt::entity entity, script&& coroutine);
+
+        /**
+         * Advance the script time by dt and resume the scripts due; a
+         * script whose entity was destroyed is dropped when it wakes up
+         */
+        void update(const float dt);
+
+        // queue coroutine to resume at time, for the awaitables
+        void resume_at(const double time, script::handle coroutine);
+        /**
+         * Fire pattern from the entity of a script, at its target if any;
+         * with in_line only when the target is horizontally in line with
+         * the entity
+         */
+        void fire(script::promise_type& promise,
+                  const components::bullet_pattern_id pattern,
+                  const bool in_line=false);
+
+        const double get_time() const { return m_time; }
+        // suspended scripts, each one waiting for a single event
+        const size_t get_waiting() const { return m_events.size(); }
+        entt::registry& get_registry() { return m_registry; }
+};
+
+namespace scripts
+{
+    // resume after seconds, at least at the next update
+    struct wait
+    {
+        float seconds;
+
+        explicit wait(const float seconds_) : seconds(seconds_) {}
+
+        bool await_ready() const { return false; }
+        void await_suspend(script::handle coroutine) const
+        {
+            ScriptScheduler* scheduler = coroutine.promise().scheduler;
+            scheduler->resume_at(scheduler->get_time() + seconds, coroutine);
+        }
+        void await_resume() const {}
+    };
+
+    /**
+     * Move the entity in a straight line at speed pixels per second;
+     * update_linear_velocity does the moving and the script wakes up
+     * once, on arrival, to stop it exactly at x, y
+     */
+    struct move_to
+    {
+        float x;
+        float y;
+        float speed;
+        script::promise_type* promise = nullptr;
+
+        move_to(const float x_, const float y_, const float speed_)
+            : x(x_), y(y_), speed(speed_) {}
+
+        bool await_ready() const { return false; }
+        bool await_suspend(script::handle coroutine);
+        void await_resume();
+    };
+
+    // fire a bullet pattern without suspending, aimed at the target
+    // component of the entity or straight down; with in_line only if
+    // the target is below or above the entity
+    struct fire
+    {
+        components::bullet_pattern_id pattern;
+        bool in_line;
+
+        explicit fire(const components::bullet_pattern_id pattern_,
+                      const bool in_line_=false)
+            : pattern(pattern_), in_line(in_line_) {}
+
+        bool await_ready() const { return false; }
+        bool await_suspend(script::handle coroutine) const
+        {
+            script::promise_type& promise = coroutine.promise();
+            promise.scheduler->fire(promise, pattern, in_line);
+            return false;
+        }
+        void await_resume() const {}
+    };
+}
+
+#endif
@@ -9,12 +9,24 @@
 
 SDL_Window* sdl_init(const int screen_width, const int screen_height);
 
+// init SDL without opening a window, for headless runs
+bool sdl_init_headless();
+
 void sdl_quit(SDL_Window* window);
 
 SDL_Surface* optimize_surface(SDL_Surface* surface, const SDL_PixelFormat* format);
 
 SDL_Surface* load_surface(const std::string& path, const SDL_PixelFormat* format=nullptr);
 
+// decode an image from stream and close it, name is used only for logging
+SDL_Surface* load_surface(SDL_RWops* stream, const std::string& name, const SDL_PixelFormat* format=nullptr);
+
+// upload surface to a texture and free it, name is used only for logging
+SDL_Texture* create_texture(SDL_Surface* surface, const std::string& name, SDL_Renderer* renderer);
+
 SDL_Texture* load_texture(const std::string path, SDL_Renderer* renderer);
 
+// the whole texture as a rect, empty for a null texture
+SDL_Rect texture_rect(SDL_Texture* texture);
+
 #endif
@@ -0,0 +1,99 @@
+/**
+ * Uniform grid used as a broadphase for collision detection.
+ * Items (an entity and its rect) are bucketed by the cells their rect
+ * overlaps; a query then only visits the items sharing a cell with the
+ * queried rect instead of every item in the scene.
+ * The grid is meant to be cleared and rebuilt every frame.
+ */
+#ifndef __SCIUTER_SPATIAL_GRID_HPP__
+#define __SCIUTER_SPATIAL_GRID_HPP__
+
+#include <algorithm>
+#include <vector>
+#include <entt/entt.hpp>
+#include <sciuter/sdl.hpp>
+
+class SpatialGrid
+{
+    public:
+        struct item
+        {
+            entt::entity entity;
+            SDL_Rect rect;
+            // range of cells covered by rect, clamped to the grid
+            int x0, y0, x1, y1;
+        };
+
+    private:
+        SDL_Rect m_bounds;
+        int m_cell_size;
+        int m_columns;
+        int m_rows;
+        std::vector<item> m_items;
+        // m_cell_start[c]..m_cell_start[c + 1] is the range of
+        // m_cell_items belonging to cell c
+        std::vector<unsigned int> m_cell_start;
+        std::vector<unsigned int> m_cell_items;
+        // scratch insertion cursor per cell, kept to avoid reallocating
+        std::vector<unsigned int> m_cell_next;
+
+        int cell_x(const int x) const;
+        int cell_y(const int y) const;
+
+    public:
+        /**
+         * bounds is the area covered by the grid (usually the screen);
+         * rects falling outside of it are clamped to the border cells,
+         * so queries are still exact, just slower for crowded borders
+         */
+        SpatialGrid(const SDL_Rect& bounds, const int cell_size=64);
+
+        void clear();
+        void insert(const entt::entity entity, const SDL_Rect& rect);
+        // bucket the inserted items, must be called before query
+        void build();
+
+        const int get_cell_size() const { return m_cell_size; }
+        const int get_item_count() const { return m_items.size(); }
+
+        /**
+         * Calls func(entity, rect) once for every item sharing at least
+         * a cell with rect; the callback returns true to stop the query.
+         * Returns true if the query has been stopped by the callback.
+         */
+        template<typename Func>
+        bool query(const SDL_Rect& rect, Func func) const
+        {
+            const int x0 = cell_x(rect.x);
+            const int y0 = cell_y(rect.y);
+            const int x1 = cell_x(rect.x + rect.w - 1);
+            const int y1 = cell_y(rect.y + rect.h - 1);
+
+            for(int cy = y0; cy <= y1; ++cy)
+            {
+                for(int cx = x0; cx <= x1; ++cx)
+                {
+                    const int cell = cy * m_columns + cx;
+                    for(auto i = m_cell_start[cell];
+                        i < m_cell_start[cell + 1]; ++i)
+                    {
+                        const item& candidate = m_items[m_cell_items[i]];
+                        // report each item only from the first cell
+                        // shared by both rects, to avoid duplicates
+                        if(cx != std::max(x0, candidate.x0) ||
+                           cy != std::max(y0, candidate.y0))
+                        {
+                            continue;
+                        }
+                        if(func(candidate.entity, candidate.rect))
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+};
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * Collects textured quads and submits every run of quads sharing the
+ * same texture with a single SDL_RenderGeometry call, instead of one
+ * SDL_RenderCopy per sprite.
+ * Quads are drawn in submission order, so the caller keeps control of
+ * the layering; sorting sprites by texture inside a layer gives longer
+ * runs and fewer draw calls.
+ * With SDL older than 2.0.18 it falls back to SDL_RenderCopy.
+ */
+#ifndef __SCIUTER_SPRITE_BATCH_HPP__
+#define __SCIUTER_SPRITE_BATCH_HPP__
+
+#include <vector>
+#include <sciuter/sdl.hpp>
+
+class SpriteBatch
+{
+    private:
+        SDL_Renderer* m_renderer = nullptr;
+        SDL_Texture* m_texture = nullptr;
+        float m_texture_width = 1.f;
+        float m_texture_height = 1.f;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+        std::vector<SDL_Vertex> m_vertices;
+#endif
+        // the index pattern depends only on the quad count, so it is
+        // built once and shared by all the draw calls
+        std::vector<int> m_indices;
+        int m_draw_calls = 0;
+        int m_sprites = 0;
+
+        void set_texture(SDL_Texture* texture);
+
+    public:
+        // start a new frame of drawing, resetting the statistics
+        void begin(SDL_Renderer* renderer);
+        void draw(SDL_Texture* texture,
+                  const SDL_Rect& source,
+                  const SDL_Rect& destination);
+        // submit the pending quads, must be called before presenting
+        void flush();
+
+        // statistics of the current frame
+        const int get_draw_calls() const { return m_draw_calls; }
+        const int get_sprites() const { return m_sprites; }
+};
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * Runs the systems of a tick as a dependency graph: every system
+ * declares the components (or other shared data, any type works as a
+ * key) it reads and writes, two systems conflict when one writes what
+ * the other touches, and conflicting systems keep the order they were
+ * added in. Systems that don't conflict run concurrently on a
+ * WorkStealingPool, so results match a sequential run in add order.
+ * Systems creating or destroying entities must be exclusive; a system
+ * assigning or removing a component may instead write that component
+ * and every pool of the groups the component takes part in, since the
+ * groups reorder them.
+ */
+#ifndef __SCIUTER_SYSTEM_SCHEDULER_HPP__
+#define __SCIUTER_SYSTEM_SCHEDULER_HPP__
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <entt/entt.hpp>
+#include <sciuter/sdl.hpp>
+#include <sciuter/work_stealing_pool.hpp>
+
+class SystemScheduler
+{
+    public:
+        typedef std::function<void(const float dt)> system_function;
+        typedef entt::component resource_id;
+
+        class system
+        {
+            private:
+                friend class SystemScheduler;
+
+                const char* m_name;
+                system_function m_function;
+                std::vector<resource_id> m_reads;
+                std::vector<resource_id> m_writes;
+                bool m_exclusive = false;
+
+                // built on the first run
+                std::vector<size_t> m_successors;
+                int m_dependencies = 0;
+                std::atomic<int> m_pending{0};
+                Uint64 m_counter_ticks = 0;
+
+            public:
+                system(const char* name, system_function function)
+                    : m_name(name), m_function(std::move(function)) {}
+
+                template<typename... Type>
+                system& reads()
+                {
+                    (m_reads.push_back(entt::registry::type<Type>()), ...);
+                    return *this;
+                }
+
+                template<typename... Type>
+                system& writes()
+                {
+                    (m_writes.push_back(entt::registry::type<Type>()), ...);
+                    return *this;
+                }
+
+                // conflicts with every other system
+                system& exclusive()
+                {
+                    m_exclusive = true;
+                    return *this;
+                }
+
+                const bool conflicts(const system& other) const;
+        };
+
+    private:
+        std::vector<std::unique_ptr<system>> m_systems;
+        std::atomic<int> m_remaining{0};
+        bool m_built = false;
+
+        void build();
+        void execute(const size_t index, const float dt, WorkStealingPool& pool);
+
+    public:
+        // name must be a string literal, it is used for profiling
+        system& add(const char* name, system_function function);
+
+        /**
+         * Run every system once, concurrently on pool or in add order
+         * without one
+         */
+        void run(const float dt, WorkStealingPool* pool=nullptr);
+
+        const size_t size() const { return m_systems.size(); }
+        const char* get_name(const size_t index) const { return m_systems[index]->m_name; }
+
+        // run time of the system during the last run, in performance counter ticks
+        const Uint64 get_counter_ticks(const size_t index) const
+        {
+            return m_systems[index]->m_counter_ticks;
+        }
+};
+
+#endif
@@ -2,39 +2,67 @@
 #define __SCIUTER_SYSTEMS_HPP__
 
 #include <string>
+#include <vector>
 #include <sciuter/sdl.hpp>
 #include <sciuter/components.hpp>
 #include <sciuter/animation.hpp>
+#include <sciuter/behaviors.hpp>
+#include <sciuter/bullet_patterns.hpp>
+#include <sciuter/bullet_pool.hpp>
+#include <sciuter/command_buffer.hpp>
+#include <sciuter/input_recording.hpp>
+#include <sciuter/render_order.hpp>
 #include <sciuter/resources.hpp>
+#include <sciuter/spatial_grid.hpp>
+#include <sciuter/sprite_batch.hpp>
+#include <sciuter/work_stealing_pool.hpp>
 
 const unsigned int COLLISION_MASK_ENEMIES = 1;
 const unsigned int COLLISION_MASK_PLAYER = 2;
 
-void update_timers(float dt, entt::registry &registry);
-void handle_gamepad(
-    const SDL_Rect& boundaries,
-    entt::registry& registry);
+// world entities closer than this to the camera view are not culled,
+// so that nothing pops in at the edges
+const int CULL_MARGIN = 32;
+
+// with a pool the entities are split in ranges run concurrently
+void store_previous_positions(entt::registry &registry,
+                              WorkStealingPool* pool=nullptr);
+// read the keyboard snapshot (or replay) into the gamepads and steer
+// their entities
+void handle_gamepad(InputRecording& input,
+                    const std::vector<Uint8>& keyboard,
+                    entt::registry& registry);
+// spawn the bullets of the gamepads firing, at the pace of their timer
+void fire_player_bullets(BulletPool& bullets, entt::registry& registry);
 
 SDL_Rect center_position(const int x, const int y, const SDL_Rect& frame_rect);
 void update_animations(const float dt, entt::registry &registry);
-void update_linear_velocity(const float dt, entt::registry& registry);
-void update_destination_rect(entt::registry& registry);
+void update_linear_velocity(const float dt,
+                            entt::registry& registry,
+                            WorkStealingPool* pool=nullptr);
+void update_destination_rect(entt::registry& registry,
+                             WorkStealingPool* pool=nullptr);
+void interpolate_destination_rect(const float alpha, entt::registry& registry);
+void cull_offscreen(const entt::entity& camera,
+		    const SDL_Rect& viewport,
+		    const int margin,
+		    entt::registry& registry);
 void apply_camera_transformation(const entt::entity& camera,
-				 entt::registry& registry);
-void update_shot_to_target_behaviour(
-    const SDL_Rect& boundaries,
-    entt::registry& registry);
-void resolve_collisions(entt::registry& registry);
-void check_boundaries(entt::registry& registry);
+				 entt::registry& registry,
+				 const float alpha=1.f);
+void resolve_collisions(SpatialGrid& grid,
+			CommandBuffer& commands,
+			entt::registry& registry);
 void render_sprites(SDL_Renderer* renderer,
-		    const int scale,
+		    SpriteBatch& batch,
+		    RenderOrder& render_order,
 		    entt::registry& registry);
 
 entt::entity spawn_bullet(
-    const components::position& position,
-    const components::velocity& velocity,
+    const components::position position,
+    const components::velocity velocity,
     const unsigned int collision_mask,
-    const SDL_Rect& boundaries,
+    BulletPool& bullets,
     entt::registry& registry);
 
 void update_behaviors(const float dt, entt::registry &registry);
@@ -0,0 +1,80 @@
+/**
+ * Event driven components::timer: every timer is a node of a
+ * hierarchical timing wheel (LEVELS wheels of SLOTS slots, each slot of a
+ * level spanning a full turn of the level below), so advancing a tick
+ * touches only the slot of that tick plus, once every SLOTS ticks, the
+ * slot of the upper level cascading down. Idle timers cost nothing.
+ * Timer components are picked up through the registry signals and
+ * scheduled at the next update, when the tick time is known; to change
+ * a timer remove it and assign a new one.
+ */
+#ifndef __SCIUTER_TIMER_WHEEL_HPP__
+#define __SCIUTER_TIMER_WHEEL_HPP__
+
+#include <vector>
+#include <entt/entt.hpp>
+#include <sciuter/components.hpp>
+
+class TimerWheel
+{
+    public:
+        static constexpr Uint32 SLOT_BITS = 6;
+        static constexpr Uint32 SLOTS = 1 << SLOT_BITS;
+        static constexpr Uint32 LEVELS = 4;
+        // longest delay, longer ones are clamped
+        static constexpr Uint64 MAX_TICKS = (Uint64(1) << (SLOT_BITS * LEVELS)) - 1;
+
+    private:
+        static constexpr Uint32 NIL = 0xffffffff;
+
+        struct node
+        {
+            entt::entity entity;
+            Uint64 expiry;
+            // ticks between expirations
+            Uint32 period;
+            Uint32 slot;
+            Uint32 prev;
+            Uint32 next;
+        };
+
+        entt::registry& m_registry;
+        std::vector<node> m_nodes;
+        Uint32 m_free = NIL;
+        Uint32 m_slots[LEVELS * SLOTS];
+        Uint64 m_now = 0;
+        size_t m_count = 0;
+        // timers assigned since the last update
+        std::vector<entt::entity> m_pending;
+        std::vector<entt::entity> m_fired;
+
+        Uint32 add(const entt::entity entity, const Uint64 delay, const Uint32 period);
+        void remove(const Uint32 handle);
+        void insert(const Uint32 handle);
+        void unlink(const Uint32 handle);
+        void cascade(const Uint32 level);
+        void advance();
+
+        void on_construct(const entt::entity entity, entt::registry&, components::timer& timer);
+        void on_destroy(const entt::entity entity, entt::registry&);
+
+    public:
+        TimerWheel(entt::registry& registry);
+        ~TimerWheel();
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        /**
+         * Advance by one tick of dt seconds: the timers expired in the
+         * previous tick are cleared and the ones expiring in this tick
+         * are flagged and listed by get_fired
+         */
+        void update(const float dt);
+
+        // entities whose timer expired in the last update
+        const std::vector<entt::entity>& get_fired() const { return m_fired; }
+        // timers scheduled in the wheel
+        const size_t size() const { return m_count; }
+};
+
+#endif
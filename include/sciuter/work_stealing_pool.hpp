@@ -0,0 +1,124 @@
+/**
+ * Thread pool for short lived, fine grained tasks like the systems of a
+ * tick: every thread owns a task deque, takes the newest task of its own
+ * deque and steals the oldest one of the others when it runs dry.
+ * The thread calling wait works as one of the threads, so a pool of n
+ * threads starts n - 1 workers.
+ * Longer tasks, like decoding assets, can be submitted for a future of
+ * their result instead.
+ */
+#ifndef __SCIUTER_WORK_STEALING_POOL_HPP__
+#define __SCIUTER_WORK_STEALING_POOL_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool
+{
+    private:
+        struct task_queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<task_queue>> m_queues;
+        std::vector<std::thread> m_workers;
+        // tasks pushed and not taken yet, sleeping workers wait on it
+        std::atomic<int> m_queued{0};
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+
+        size_t current_queue() const;
+        bool pop(const size_t queue, std::function<void()>& task);
+        bool steal(const size_t thief, std::function<void()>& task);
+        bool run_one(const size_t queue);
+        void work(const size_t queue);
+
+    public:
+        // zero threads means one per hardware thread
+        explicit WorkStealingPool(size_t threads=0);
+        ~WorkStealingPool();
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // threads running tasks, the waiting thread included
+        const size_t size() const { return m_queues.size(); }
+
+        // queue a task on the deque of the calling thread
+        void push(std::function<void()> task);
+
+        /**
+         * Run tasks on the calling thread until remaining drops to zero;
+         * once there are none left to run it sleeps until remaining
+         * changes, so whoever decrements it has to notify_all
+         */
+        void wait(const std::atomic<int>& remaining);
+
+        /**
+         * Call func(begin, end) over ranges of [0, count) of at least
+         * grain items, one per thread at most, on the calling thread and
+         * the workers; returns once every range is done
+         */
+        template<typename Func>
+        void parallel_for(const size_t count, const size_t grain, Func func)
+        {
+            const size_t ranges = std::min(size(), (count + grain - 1) / grain);
+            if(ranges < 2)
+            {
+                func(0, count);
+                return;
+            }
+
+            // the last range notifies after the count drops to zero, when
+            // this call may have returned: the count can't be on the stack
+            const size_t step = (count + ranges - 1) / ranges;
+            auto remaining = std::make_shared<std::atomic<int>>(ranges - 1);
+            for(size_t range = 1; range < ranges; ++range)
+            {
+                const size_t begin = std::min(count, range * step);
+                const size_t end = std::min(count, begin + step);
+                push([&func, remaining, begin, end] {
+                    func(begin, end);
+                    remaining->fetch_sub(1, std::memory_order_release);
+                    remaining->notify_all();
+                });
+            }
+            func(0, step);
+            wait(*remaining);
+        }
+
+        /**
+         * Queue a task and return a future to its result; without
+         * workers, in a pool of one thread, the task runs right away
+         */
+        template<typename Func>
+        auto submit(Func func) -> std::future<decltype(func())>
+        {
+            // std::function needs a copyable callable, packaged_task
+            // is move only so it is kept behind a shared_ptr
+            auto task = std::make_shared<std::packaged_task<decltype(func())()>>(
+                std::move(func));
+            auto result = task->get_future();
+            if(m_workers.empty())
+            {
+                (*task)();
+            }
+            else
+            {
+                push([task] { (*task)(); });
+            }
+            return result;
+        }
+};
+
+#endif
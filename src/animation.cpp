@@ -1,16 +1,19 @@
+#include <cstring>
 #include <fstream>
 #include <istream>
 #include <string>
 #include <vector>
+// the bundled json header predates C++20 and still uses std::is_pod
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #include <nlohmann/json.hpp>
+#pragma GCC diagnostic pop
 #include <sciuter/animation.hpp>
 
 using json = nlohmann::json;
 
-AnimationMap TexturePackerAnimationLoader::load(std::istream &input)
+static AnimationMap from_json(json& j)
 {
-    json j;
-    input >> j;
     std::vector<SDL_Rect> rects;
     std::map<std::string, SDL_Rect> all_frames;
     AnimationMap animations;
@@ -38,9 +41,125 @@ AnimationMap TexturePackerAnimationLoader::load(std::istream &input)
     return animations;
 }
 
+AnimationMap TexturePackerAnimationLoader::load(std::istream &input)
+{
+    json j;
+    input >> j;
+    return from_json(j);
+}
+
+AnimationMap TexturePackerAnimationLoader::load(const char* data, const size_t size)
+{
+    json j = json::parse(data, data + size);
+    return from_json(j);
+}
+
 AnimationMap TexturePackerAnimationLoader::load(const std::string filename)
 {
     std::ifstream input(filename);
     auto animation = load(input);
     return animation;
 }
+
+std::vector<char> BinaryAnimationLoader::write(const AnimationMap& animations)
+{
+    animation_table_header header;
+    memcpy(header.magic, ANIMATION_TABLE_MAGIC, sizeof(ANIMATION_TABLE_MAGIC));
+    header.version = ANIMATION_TABLE_VERSION;
+    header.frame_count = 0;
+    header.animation_count = animations.size();
+    header.names_size = 0;
+
+    std::vector<SDL_Rect> frames;
+    std::vector<animation_range> ranges;
+    std::string names;
+
+    for(const auto& [name, animation] : animations)
+    {
+        const auto& animation_frames = animation.get_frames();
+        ranges.push_back({(Uint32)names.size(), (Uint32)name.size(),
+                          (Uint32)frames.size(), (Uint32)animation_frames.size()});
+        frames.insert(frames.end(), animation_frames.begin(), animation_frames.end());
+        names += name;
+    }
+    header.frame_count = frames.size();
+    header.names_size = names.size();
+
+    const size_t frames_size = frames.size() * sizeof(SDL_Rect);
+    const size_t ranges_size = ranges.size() * sizeof(animation_range);
+    std::vector<char> table(sizeof(header) + frames_size + ranges_size + names.size());
+
+    char* output = table.data();
+    memcpy(output, &header, sizeof(header));
+    output += sizeof(header);
+    memcpy(output, frames.data(), frames_size);
+    output += frames_size;
+    memcpy(output, ranges.data(), ranges_size);
+    output += ranges_size;
+    memcpy(output, names.data(), names.size());
+
+    return table;
+}
+
+AnimationMap BinaryAnimationLoader::load(const char* data, const size_t size)
+{
+    AnimationMap animations;
+    animation_table_header header;
+
+    if(size < sizeof(header) || ((uintptr_t)data % alignof(SDL_Rect)) != 0)
+    {
+        SDL_Log("Animation table is truncated or misaligned");
+        return animations;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    if(memcmp(header.magic, ANIMATION_TABLE_MAGIC, sizeof(ANIMATION_TABLE_MAGIC)) != 0 ||
+       header.version != ANIMATION_TABLE_VERSION)
+    {
+        SDL_Log("Animation table has an unknown format");
+        return animations;
+    }
+
+    // 64 bit sizes can't overflow with 32 bit counts
+    const Uint64 frames_size = (Uint64)header.frame_count * sizeof(SDL_Rect);
+    const Uint64 ranges_size = (Uint64)header.animation_count * sizeof(animation_range);
+    if(sizeof(header) + frames_size + ranges_size + header.names_size > size)
+    {
+        SDL_Log("Animation table is truncated");
+        return animations;
+    }
+
+    // the header size keeps both arrays aligned
+    const SDL_Rect* frames = reinterpret_cast<const SDL_Rect*>(data + sizeof(header));
+    const animation_range* ranges = reinterpret_cast<const animation_range*>(
+        data + sizeof(header) + frames_size);
+    const char* names = data + sizeof(header) + frames_size + ranges_size;
+
+    for(Uint32 i = 0; i < header.animation_count; ++i)
+    {
+        const animation_range& range = ranges[i];
+        if(range.name_offset > header.names_size ||
+           range.name_size > header.names_size - range.name_offset ||
+           range.first_frame > header.frame_count ||
+           range.frame_count > header.frame_count - range.first_frame)
+        {
+            SDL_Log("Animation table has a corrupted range");
+            return AnimationMap();
+        }
+
+        const std::string name(names + range.name_offset, range.name_size);
+        animations[name] = Animation(
+            std::vector<SDL_Rect>(frames + range.first_frame,
+                                  frames + range.first_frame + range.frame_count),
+            name);
+    }
+    return animations;
+}
+
+AnimationMap BinaryAnimationLoader::load(const std::string filename)
+{
+    std::ifstream input(filename, std::ios::binary);
+    const std::vector<char> data((std::istreambuf_iterator<char>(input)),
+                                 std::istreambuf_iterator<char>());
+    return load(data.data(), data.size());
+}
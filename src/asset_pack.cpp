@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sciuter/asset_pack.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SCIUTER_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool AssetPack::open(const std::string& path)
+{
+    close();
+
+#ifdef SCIUTER_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after closing its descriptor
+    ::close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        SDL_Log("Unable to map asset pack %s", path.c_str());
+        return false;
+    }
+
+    m_data = static_cast<const char*>(mapping);
+    m_size = info.st_size;
+#else
+    std::ifstream input(path, std::ios::binary);
+    if(!input)
+    {
+        return false;
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(input),
+                    std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#endif
+
+    if(!validate(path))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::validate(const std::string& path)
+{
+    pack_header header;
+
+    if(m_size < sizeof(header))
+    {
+        SDL_Log("Asset pack %s is truncated", path.c_str());
+        return false;
+    }
+    memcpy(&header, m_data, sizeof(header));
+
+    if(memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 ||
+       header.version != PACK_VERSION)
+    {
+        SDL_Log("Asset pack %s has an unknown format", path.c_str());
+        return false;
+    }
+
+    if((m_size - sizeof(header)) / sizeof(pack_entry) < header.entry_count)
+    {
+        SDL_Log("Asset pack %s is truncated", path.c_str());
+        return false;
+    }
+
+    // the header size keeps the entry table aligned in the mapping
+    m_entries = reinterpret_cast<const pack_entry*>(m_data + sizeof(header));
+    m_entry_count = header.entry_count;
+
+    for(Uint32 i = 0; i < m_entry_count; ++i)
+    {
+        const pack_entry& entry = m_entries[i];
+        if(entry.offset > m_size || entry.size > m_size - entry.offset ||
+           (i > 0 && m_entries[i - 1].id >= entry.id))
+        {
+            SDL_Log("Asset pack %s has a corrupted index", path.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPack::close()
+{
+#ifdef SCIUTER_HAS_MMAP
+    if(nullptr != m_data)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_entry_count = 0;
+}
+
+bool AssetPack::find(const Uint32 id, asset& result) const
+{
+    const pack_entry* end = m_entries + m_entry_count;
+    const pack_entry* entry = std::lower_bound(
+        m_entries, end, id,
+        [](const pack_entry& entry, const Uint32 id) { return entry.id < id; });
+
+    if(entry == end || entry->id != id)
+    {
+        return false;
+    }
+
+    result = {entry->type, m_data + entry->offset, (size_t)entry->size};
+    return true;
+}
+
+SDL_RWops* AssetPack::open_stream(const Uint32 id) const
+{
+    asset found;
+    if(!find(id, found))
+    {
+        return nullptr;
+    }
+    return SDL_RWFromConstMem(found.data, found.size);
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <sciuter/atlas.hpp>
+
+SkylinePacker::SkylinePacker(const int width, const int height)
+    : m_width(width), m_height(height)
+{
+    m_skyline.push_back({0, 0, width});
+}
+
+int SkylinePacker::fit(const size_t index, const int w, const int h) const
+{
+    const int x = m_skyline[index].x;
+    if(x + w > m_width)
+    {
+        return -1;
+    }
+
+    // the rect rests on the highest segment it spans
+    int y = 0;
+    int remaining = w;
+    for(size_t i = index; remaining > 0; ++i)
+    {
+        y = std::max(y, m_skyline[i].y);
+        remaining -= m_skyline[i].width;
+    }
+
+    return y + h <= m_height ? y : -1;
+}
+
+bool SkylinePacker::insert(const int w, const int h, SDL_Rect& result)
+{
+    int best_index = -1;
+    int best_y = m_height;
+    int best_width = m_width;
+
+    for(size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        const int y = fit(i, w, h);
+        if(y >= 0 && (y < best_y ||
+                      (y == best_y && m_skyline[i].width < best_width)))
+        {
+            best_index = i;
+            best_y = y;
+            best_width = m_skyline[i].width;
+        }
+    }
+
+    if(best_index < 0)
+    {
+        return false;
+    }
+
+    result = {m_skyline[best_index].x, best_y, w, h};
+
+    // the new segment covers the rect, shrink or drop the ones under it
+    m_skyline.insert(m_skyline.begin() + best_index, {result.x, best_y + h, w});
+
+    const int right = result.x + w;
+    for(size_t i = best_index + 1; i < m_skyline.size();)
+    {
+        segment& covered = m_skyline[i];
+        if(covered.x >= right)
+        {
+            break;
+        }
+
+        const int shrink = right - covered.x;
+        if(shrink < covered.width)
+        {
+            covered.x += shrink;
+            covered.width -= shrink;
+            break;
+        }
+        m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    // merge neighbours at the same height
+    for(size_t i = 0; i + 1 < m_skyline.size();)
+    {
+        if(m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    return true;
+}
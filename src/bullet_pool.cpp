@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <sciuter/bullet_pool.hpp>
+
+BulletPool::BulletPool(entt::registry& registry,
+                       const SDL_Rect& boundaries,
+                       const size_t grow_size)
+    : m_registry(registry), m_boundaries(boundaries), m_grow_size(grow_size)
+{
+    registry.on_construct<components::inactive>().connect<&BulletPool::on_park>(*this);
+    registry.on_destroy<components::bullet_slot>().connect<&BulletPool::on_park>(*this);
+}
+
+BulletPool::~BulletPool()
+{
+    m_registry.on_construct<components::inactive>().disconnect(*this);
+    m_registry.on_destroy<components::bullet_slot>().disconnect(*this);
+}
+
+void BulletPool::on_park(const entt::entity bullet, entt::registry& registry)
+{
+    auto slot = registry.try_get<components::bullet_slot>(bullet);
+    if(nullptr == slot || slot->index == components::bullet_slot::NONE)
+    {
+        return;
+    }
+
+    // the last bullet of the store takes the free index
+    const Uint32 index = slot->index;
+    const entt::entity last = m_entities.back();
+    m_store.remove(index);
+    m_entities[index] = last;
+    m_entities.pop_back();
+    registry.get<components::bullet_slot>(last).index = index;
+    slot->index = components::bullet_slot::NONE;
+}
+
+void BulletPool::set_prototype(const unsigned int collision_mask,
+                               SDL_Texture* texture,
+                               const SDL_Rect& source,
+                               const int damage)
+{
+    const prototype bullet = {collision_mask, texture, source, damage};
+
+    for(auto& existing : m_prototypes)
+    {
+        if(existing.collision_mask == collision_mask)
+        {
+            existing = bullet;
+            return;
+        }
+    }
+    m_prototypes.push_back(bullet);
+}
+
+const BulletPool::prototype* BulletPool::get_prototype(
+    const unsigned int collision_mask) const
+{
+    // just a handful of prototypes, a linear scan is the fastest lookup
+    for(auto& bullet : m_prototypes)
+    {
+        if(bullet.collision_mask == collision_mask)
+        {
+            return &bullet;
+        }
+    }
+    return nullptr;
+}
+
+void BulletPool::reserve(const size_t count, entt::registry& registry)
+{
+    if(count > m_size)
+    {
+        grow(count - m_size, registry);
+    }
+}
+
+void BulletPool::reserve_parked(const size_t count, entt::registry& registry)
+{
+    const size_t parked = registry.view<components::inactive>().size();
+    if(count > parked)
+    {
+        grow(std::max(count - parked, m_grow_size), registry);
+    }
+}
+
+void BulletPool::grow(const size_t count, entt::registry& registry)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        auto bullet = registry.create();
+        registry.assign<components::position>(bullet, 0.f, 0.f);
+        registry.assign<components::previous_position>(bullet, 0.f, 0.f);
+        registry.assign<components::velocity>(bullet, 0.f, 0.f, 0.f);
+        registry.assign<components::source_rect>(bullet);
+        registry.assign<components::destination_rect>(bullet);
+        registry.assign<components::bullet_slot>(bullet);
+        registry.assign<components::damage>(bullet, 0);
+        registry.assign<components::collision_mask>(bullet, 0u);
+        registry.assign<components::image>(bullet, nullptr);
+        registry.assign<components::draw_order>(bullet, 1);
+        registry.assign<components::inactive>(bullet);
+    }
+    m_size += count;
+    m_store.reserve(m_size);
+    m_entities.reserve(m_size);
+}
+
+entt::entity BulletPool::acquire(
+    const components::position position,
+    const components::velocity velocity,
+    const unsigned int collision_mask,
+    entt::registry& registry)
+{
+    const prototype* found = get_prototype(collision_mask);
+    if(nullptr == found)
+    {
+        SDL_Log("No bullet prototype for collision mask %u", collision_mask);
+        return entt::null;
+    }
+    const prototype& bullet_prototype = *found;
+
+    auto parked = registry.view<components::inactive>();
+
+    if(parked.empty())
+    {
+        // only happens while the pool warms up to the peak bullet count
+        grow(m_grow_size, registry);
+    }
+
+    const auto bullet = *parked.begin();
+
+    registry.remove<components::inactive>(bullet);
+    registry.get<components::position>(bullet) = position;
+    registry.get<components::previous_position>(bullet) = {position.x, position.y};
+    registry.get<components::velocity>(bullet) = velocity;
+    registry.get<components::source_rect>(bullet).rect = bullet_prototype.source_rect;
+    // centered on the spawn position, so that a bullet spawned after
+    // update_destination_rect is not drawn where its last life ended
+    registry.get<components::destination_rect>(bullet) = {
+        (int)position.x - bullet_prototype.source_rect.w / 2,
+        (int)position.y - bullet_prototype.source_rect.h / 2,
+        bullet_prototype.source_rect.w,
+        bullet_prototype.source_rect.h};
+    registry.get<components::image>(bullet).texture = bullet_prototype.texture;
+    registry.get<components::damage>(bullet).value = bullet_prototype.damage;
+    registry.get<components::collision_mask>(bullet).value = collision_mask;
+
+    registry.get<components::bullet_slot>(bullet).index = m_store.add(
+        position.x, position.y, velocity.dx, velocity.dy, velocity.speed,
+        bullet_prototype.source_rect.w, bullet_prototype.source_rect.h);
+    m_entities.push_back(bullet);
+
+    return bullet;
+}
+
+void BulletPool::update(const float dt, CommandBuffer& commands, entt::registry& registry)
+{
+    const size_t outside = m_store.update(dt, m_boundaries);
+
+    const float* x = m_store.get_x();
+    const float* y = m_store.get_y();
+    for(size_t i = 0; i < m_entities.size(); ++i)
+    {
+        const entt::entity bullet = m_entities[i];
+        auto &position = registry.get<components::position>(bullet);
+        position.x = x[i];
+        position.y = y[i];
+        registry.get<components::destination_rect>(bullet) = m_store.get_rect(i);
+    }
+
+    if(outside > 0)
+    {
+        const Uint8* flags = m_store.get_outside();
+        for(size_t i = 0; i < m_entities.size(); ++i)
+        {
+            if(flags[i])
+            {
+                release(m_entities[i], commands);
+            }
+        }
+    }
+}
@@ -0,0 +1,287 @@
+#include <sciuter/bullet_store.hpp>
+
+// the AVX2 kernel is compiled for AVX2 on its own and picked at run
+// time, the rest of the build keeps the baseline instruction set
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCIUTER_HAS_AVX2_KERNEL
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+size_t BulletStore::add(const float x, const float y,
+                        const float dx, const float dy, const float speed,
+                        const int w, const int h)
+{
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_dx.push_back(dx);
+    m_dy.push_back(dy);
+    m_speed.push_back(speed);
+    m_w.push_back(w);
+    m_h.push_back(h);
+    m_rect_x.push_back(0);
+    m_rect_y.push_back(0);
+    m_outside.push_back(0);
+    return m_x.size() - 1;
+}
+
+void BulletStore::reserve(const size_t count)
+{
+    m_x.reserve(count);
+    m_y.reserve(count);
+    m_dx.reserve(count);
+    m_dy.reserve(count);
+    m_speed.reserve(count);
+    m_w.reserve(count);
+    m_h.reserve(count);
+    m_rect_x.reserve(count);
+    m_rect_y.reserve(count);
+    m_outside.reserve(count);
+}
+
+void BulletStore::clear()
+{
+    m_x.clear();
+    m_y.clear();
+    m_dx.clear();
+    m_dy.clear();
+    m_speed.clear();
+    m_w.clear();
+    m_h.clear();
+    m_rect_x.clear();
+    m_rect_y.clear();
+    m_outside.clear();
+}
+
+// arrays of the store, so that kernels work on plain pointers
+struct bullet_arrays
+{
+    float* x;
+    float* y;
+    const float* dx;
+    const float* dy;
+    const float* speed;
+    const Sint32* w;
+    const Sint32* h;
+    Sint32* rect_x;
+    Sint32* rect_y;
+    Uint8* outside;
+};
+
+// same operations, in the same order, of update_linear_velocity,
+// center_position and check_boundaries
+static size_t update_scalar(const bullet_arrays& a, size_t begin, const size_t end,
+                            const float dt, const SDL_Rect& bounds)
+{
+    size_t outside = 0;
+    for(size_t i = begin; i < end; ++i)
+    {
+        a.x[i] += a.dx[i] * a.speed[i] * dt;
+        a.y[i] += a.dy[i] * a.speed[i] * dt;
+
+        const Sint32 rect_x = (Sint32)a.x[i] - a.w[i] / 2;
+        const Sint32 rect_y = (Sint32)a.y[i] - a.h[i] / 2;
+        a.rect_x[i] = rect_x;
+        a.rect_y[i] = rect_y;
+
+        const bool inside =
+            rect_x + a.w[i] > bounds.x && bounds.x + bounds.w > rect_x &&
+            rect_y + a.h[i] > bounds.y && bounds.y + bounds.h > rect_y;
+        a.outside[i] = !inside;
+        outside += !inside;
+    }
+    return outside;
+}
+
+#if defined(SCIUTER_HAS_AVX2_KERNEL)
+
+__attribute__((target("avx2")))
+static size_t update_avx2(const bullet_arrays& a, const size_t count,
+                          const float dt, const SDL_Rect& bounds)
+{
+    const __m256 step = _mm256_set1_ps(dt);
+    const __m256i left = _mm256_set1_epi32(bounds.x);
+    const __m256i right = _mm256_set1_epi32(bounds.x + bounds.w);
+    const __m256i top = _mm256_set1_epi32(bounds.y);
+    const __m256i bottom = _mm256_set1_epi32(bounds.y + bounds.h);
+
+    size_t outside = 0;
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        const __m256 speed = _mm256_loadu_ps(a.speed + i);
+        const __m256 x = _mm256_add_ps(
+            _mm256_loadu_ps(a.x + i),
+            _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(a.dx + i), speed), step));
+        const __m256 y = _mm256_add_ps(
+            _mm256_loadu_ps(a.y + i),
+            _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(a.dy + i), speed), step));
+        _mm256_storeu_ps(a.x + i, x);
+        _mm256_storeu_ps(a.y + i, y);
+
+        const __m256i w = _mm256_loadu_si256((const __m256i*)(a.w + i));
+        const __m256i h = _mm256_loadu_si256((const __m256i*)(a.h + i));
+        // w / 2 of a non negative size
+        const __m256i rect_x = _mm256_sub_epi32(_mm256_cvttps_epi32(x),
+                                                _mm256_srai_epi32(w, 1));
+        const __m256i rect_y = _mm256_sub_epi32(_mm256_cvttps_epi32(y),
+                                                _mm256_srai_epi32(h, 1));
+        _mm256_storeu_si256((__m256i*)(a.rect_x + i), rect_x);
+        _mm256_storeu_si256((__m256i*)(a.rect_y + i), rect_y);
+
+        const __m256i inside = _mm256_and_si256(
+            _mm256_and_si256(
+                _mm256_cmpgt_epi32(_mm256_add_epi32(rect_x, w), left),
+                _mm256_cmpgt_epi32(right, rect_x)),
+            _mm256_and_si256(
+                _mm256_cmpgt_epi32(_mm256_add_epi32(rect_y, h), top),
+                _mm256_cmpgt_epi32(bottom, rect_y)));
+
+        const int flags = ~_mm256_movemask_ps(_mm256_castsi256_ps(inside)) & 0xff;
+        for(int lane = 0; lane < 8; ++lane)
+        {
+            a.outside[i + lane] = (flags >> lane) & 1;
+        }
+        outside += __builtin_popcount(flags);
+    }
+    return outside + update_scalar(a, i, count, dt, bounds);
+}
+
+#endif
+
+#if defined(__SSE2__)
+
+static size_t update_sse2(const bullet_arrays& a, const size_t count,
+                          const float dt, const SDL_Rect& bounds)
+{
+    const __m128 step = _mm_set1_ps(dt);
+    const __m128i left = _mm_set1_epi32(bounds.x);
+    const __m128i right = _mm_set1_epi32(bounds.x + bounds.w);
+    const __m128i top = _mm_set1_epi32(bounds.y);
+    const __m128i bottom = _mm_set1_epi32(bounds.y + bounds.h);
+
+    size_t outside = 0;
+    size_t i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        const __m128 speed = _mm_loadu_ps(a.speed + i);
+        const __m128 x = _mm_add_ps(
+            _mm_loadu_ps(a.x + i),
+            _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(a.dx + i), speed), step));
+        const __m128 y = _mm_add_ps(
+            _mm_loadu_ps(a.y + i),
+            _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(a.dy + i), speed), step));
+        _mm_storeu_ps(a.x + i, x);
+        _mm_storeu_ps(a.y + i, y);
+
+        const __m128i w = _mm_loadu_si128((const __m128i*)(a.w + i));
+        const __m128i h = _mm_loadu_si128((const __m128i*)(a.h + i));
+        // w / 2 of a non negative size
+        const __m128i rect_x = _mm_sub_epi32(_mm_cvttps_epi32(x),
+                                             _mm_srai_epi32(w, 1));
+        const __m128i rect_y = _mm_sub_epi32(_mm_cvttps_epi32(y),
+                                             _mm_srai_epi32(h, 1));
+        _mm_storeu_si128((__m128i*)(a.rect_x + i), rect_x);
+        _mm_storeu_si128((__m128i*)(a.rect_y + i), rect_y);
+
+        const __m128i inside = _mm_and_si128(
+            _mm_and_si128(
+                _mm_cmpgt_epi32(_mm_add_epi32(rect_x, w), left),
+                _mm_cmpgt_epi32(right, rect_x)),
+            _mm_and_si128(
+                _mm_cmpgt_epi32(_mm_add_epi32(rect_y, h), top),
+                _mm_cmpgt_epi32(bottom, rect_y)));
+
+        const int flags = ~_mm_movemask_ps(_mm_castsi128_ps(inside)) & 0xf;
+        for(int lane = 0; lane < 4; ++lane)
+        {
+            a.outside[i + lane] = (flags >> lane) & 1;
+        }
+        outside += __builtin_popcount(flags);
+    }
+    return outside + update_scalar(a, i, count, dt, bounds);
+}
+
+#endif
+
+#if defined(SCIUTER_HAS_AVX2_KERNEL)
+static bool cpu_has_avx2()
+{
+    // this runs among the static constructors, maybe before the ones
+    // filling the cpu model
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static const bool s_avx2 = cpu_has_avx2();
+#else
+static const bool s_avx2 = false;
+#endif
+
+static size_t update_simd(const bullet_arrays& a, const size_t count,
+                          const float dt, const SDL_Rect& bounds)
+{
+#if defined(SCIUTER_HAS_AVX2_KERNEL)
+    if(s_avx2)
+    {
+        return update_avx2(a, count, dt, bounds);
+    }
+#endif
+#if defined(__SSE2__)
+    return update_sse2(a, count, dt, bounds);
+#else
+    return update_scalar(a, 0, count, dt, bounds);
+#endif
+}
+
+const char* BulletStore::get_simd_name()
+{
+#if defined(__SSE2__)
+    return s_avx2 ? "avx2" : "sse2";
+#else
+    return s_avx2 ? "avx2" : "scalar";
+#endif
+}
+
+size_t BulletStore::update(const float dt, const SDL_Rect& boundaries,
+                           const kernel use)
+{
+    const bullet_arrays arrays = {
+        m_x.data(), m_y.data(), m_dx.data(), m_dy.data(), m_speed.data(),
+        m_w.data(), m_h.data(), m_rect_x.data(), m_rect_y.data(),
+        m_outside.data()};
+
+    if(use == kernel::scalar)
+    {
+        return update_scalar(arrays, 0, size(), dt, boundaries);
+    }
+    return update_simd(arrays, size(), dt, boundaries);
+}
+
+void BulletStore::remove(const size_t index)
+{
+    const size_t last = size() - 1;
+
+    m_x[index] = m_x[last];
+    m_y[index] = m_y[last];
+    m_dx[index] = m_dx[last];
+    m_dy[index] = m_dy[last];
+    m_speed[index] = m_speed[last];
+    m_w[index] = m_w[last];
+    m_h[index] = m_h[last];
+    m_rect_x[index] = m_rect_x[last];
+    m_rect_y[index] = m_rect_y[last];
+    m_outside[index] = m_outside[last];
+
+    m_x.pop_back();
+    m_y.pop_back();
+    m_dx.pop_back();
+    m_dy.pop_back();
+    m_speed.pop_back();
+    m_w.pop_back();
+    m_h.pop_back();
+    m_rect_x.pop_back();
+    m_rect_y.pop_back();
+    m_outside.pop_back();
+}
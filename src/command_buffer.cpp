@@ -0,0 +1,37 @@
+#include <sciuter/command_buffer.hpp>
+
+void CommandBuffer::release()
+{
+    command* recorded = m_first;
+    while(nullptr != recorded)
+    {
+        command* next = recorded->next;
+        recorded->release(m_memory);
+        recorded = next;
+    }
+    m_first = nullptr;
+    m_last = nullptr;
+}
+
+void CommandBuffer::flush(entt::registry& registry)
+{
+    for(command* recorded = m_first; nullptr != recorded; recorded = recorded->next)
+    {
+        recorded->apply(registry, m_created);
+    }
+
+    // destruction goes last so that components assigned during the frame
+    // to a dying entity do not resurrect it
+    for(auto entity : m_destroyed)
+    {
+        if(registry.valid(entity))
+        {
+            registry.destroy(entity);
+        }
+    }
+
+    release();
+    m_created.clear();
+    m_destroyed.clear();
+    m_pending_count = 0;
+}
@@ -0,0 +1,81 @@
+#include <sciuter/frame_arena.hpp>
+
+FrameArena::FrameArena(const size_t capacity, std::pmr::memory_resource* upstream)
+    : m_upstream(upstream), m_current(&m_buffers[0])
+{
+    for(auto& target : m_buffers)
+    {
+        target.memory.reset(new char[capacity]);
+        target.capacity = capacity;
+    }
+}
+
+FrameArena::~FrameArena()
+{
+    for(auto& target : m_buffers)
+    {
+        for(auto& block : target.overflows)
+        {
+            m_upstream->deallocate(block.memory, block.bytes, block.alignment);
+        }
+    }
+}
+
+void* FrameArena::do_allocate(const size_t bytes, const size_t alignment)
+{
+    buffer& target = *m_current;
+    target.allocations.fetch_add(1, std::memory_order_relaxed);
+    target.requested.fetch_add(bytes, std::memory_order_relaxed);
+
+    // alignment is relative to the block start, operator new[] aligns
+    // it for every fundamental type
+    size_t offset = target.offset.load(std::memory_order_relaxed);
+    size_t start;
+    do
+    {
+        start = (offset + alignment - 1) & ~(alignment - 1);
+        if(start + bytes > target.capacity ||
+           alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            void* memory = m_upstream->allocate(bytes, alignment);
+            std::lock_guard<std::mutex> lock(m_overflow_mutex);
+            target.overflows.push_back({memory, bytes, alignment});
+            return memory;
+        }
+    }
+    while(!target.offset.compare_exchange_weak(offset, start + bytes,
+                                               std::memory_order_relaxed));
+
+    return target.memory.get() + start;
+}
+
+void FrameArena::rewind(buffer& target)
+{
+    if(!target.overflows.empty())
+    {
+        for(auto& block : target.overflows)
+        {
+            m_upstream->deallocate(block.memory, block.bytes, block.alignment);
+        }
+        target.overflows.clear();
+
+        // what was requested, plus the padding, fits next time
+        size_t capacity = target.capacity;
+        while(capacity < target.requested + target.requested / 8)
+        {
+            capacity *= 2;
+        }
+        target.memory.reset(new char[capacity]);
+        target.capacity = capacity;
+    }
+
+    target.offset.store(0, std::memory_order_relaxed);
+    target.requested.store(0, std::memory_order_relaxed);
+    target.allocations.store(0, std::memory_order_relaxed);
+}
+
+void FrameArena::swap()
+{
+    m_current = m_current == &m_buffers[0] ? &m_buffers[1] : &m_buffers[0];
+    rewind(*m_current);
+}
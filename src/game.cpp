@@ -8,38 +8,49 @@
 #include <sciuter/components.hpp>
 #include <sciuter/behaviors.hpp>
 #include <sciuter/animation.hpp>
+#include <sciuter/asset_pack.hpp>
+#include <sciuter/profiler.hpp>
+#include <sciuter/resource_loader.hpp>
 #include <sciuter/resources.hpp>
+#include <sciuter/scripts.hpp>
 #include <sciuter/systems.hpp>
 
-//game dimension constants
-const int AREA_WIDTH = 640;
-const int AREA_HEIGHT = 480;
+// longest frame time simulated, in seconds
+const double MAX_FRAME_TIME = 0.25;
+
+// built from resources/assets.txt by sciuter_pack
+const char* ASSET_PACK_PATH = "resources/assets.pak";
 
 using namespace std;
 
+// the look of the streamed enemies, resolved once by load_resources
+// instead of at every spawn
+static animation_clip_id ufo_clip = 0;
+static SDL_Texture* ufo_texture = nullptr;
+
 entt::entity create_player_entity(
         entt::registry& registry)
 {
     // KeyActionMap holds an association between "low level" key code
-    // to high level action which is represented by a string
-    // the action could be a more efficient compile time hashed string but
-    // for now a plain old string is enough
+    // to high level action; actions are bits of the gamepad status so
+    // checking them is a single bit operation
     const components::KeyActionMap key_map = {
-        {SDL_SCANCODE_LEFT, "move_left"},
-        {SDL_SCANCODE_RIGHT, "move_right"},
-        {SDL_SCANCODE_UP, "move_up"},
-        {SDL_SCANCODE_DOWN, "move_down"},
-        {SDL_SCANCODE_Z, "fire"}
+        {SDL_SCANCODE_LEFT, components::action::move_left},
+        {SDL_SCANCODE_RIGHT, components::action::move_right},
+        {SDL_SCANCODE_UP, components::action::move_up},
+        {SDL_SCANCODE_DOWN, components::action::move_down},
+        {SDL_SCANCODE_Z, components::action::fire}
     };
 
-    const AnimationMap& animations = Resources::get_animations("player-animations"_hs)->value;
-
     auto entity = registry.create();
     registry.assign<components::position>(entity, 100.f, 300.f);
+    registry.assign<components::previous_position>(entity, 100.f, 300.f);
     registry.assign<components::velocity>(entity, 0.f, 0.f, 150.f);
     registry.assign<components::source_rect>(entity);
     registry.assign<components::destination_rect>(entity);
-    registry.assign<components::animation>(entity, animations.at("player"), .6f);
+    registry.assign<components::animation>(
+            entity,
+            Resources::make_animation_clip("player-animations"_hs, "player", .6f));
     registry.assign<components::image>(
             entity,
             Resources::get_texture("player"_hs)->value);
@@ -59,51 +70,71 @@ entt::entity create_enemy_entity(
         const float x, const float y,
         entt::registry& registry)
 {
-    const AnimationMap& animations = Resources::get_animations("ufo-animations"_hs)->value;
-
     auto enemy = registry.create();
     registry.assign<components::position>(enemy, x, y);
+    registry.assign<components::previous_position>(enemy, x, y);
     registry.assign<components::velocity>(enemy, 1.f, 0.f, 50.f);
     registry.assign<components::world_position>(enemy);
     registry.assign<components::source_rect>(enemy);
     registry.assign<components::destination_rect>(enemy);
     registry.assign<components::energy>(enemy, 100);
-    registry.assign<components::animation>(enemy, animations.at("ufo"), .5f);
+    registry.assign<components::animation>(enemy, ufo_clip);
     registry.assign<components::collision_mask>(enemy, COLLISION_MASK_ENEMIES);
-    registry.assign<components::image>(
-            enemy,
-            Resources::get_texture("ufo"_hs)->value);
+    registry.assign<components::image>(enemy, ufo_texture);
     registry.assign<components::draw_order>(enemy, 1);
-    registry.assign<components::entity_behavior>(enemy, new BossBehavior());
+    registry.assign<components::boss_behavior>(enemy);
     return enemy;
 }
 
+// moved and fired by boss_script
 entt::entity create_boss_entity(const float x, const float y,
                                   entt::entity &target,
                                   entt::registry &registry) {
-  auto texture = Resources::get_texture("boss"_hs)->value;
+  auto sprite = Resources::get_texture("boss"_hs);
   auto enemy = registry.create();
   registry.assign<components::position>(enemy, x, y, true);
-  registry.assign<components::velocity>(enemy, 1.f, 0.f, 50.f);
+  registry.assign<components::previous_position>(enemy, x, y);
+  registry.assign<components::velocity>(enemy, 0.f, 0.f, 0.f);
   registry.assign<components::world_position>(enemy);
-  registry.assign<components::source_rect>(
-      enemy, components::source_rect::from_texture(texture));
+  registry.assign<components::source_rect>(enemy, sprite->rect);
   registry.assign<components::destination_rect>(enemy);
   registry.assign<components::energy>(enemy, 1000);
-  registry.assign<components::timer>(enemy, 0.5f);
   registry.assign<components::target>(enemy, target);
-  registry.assign<components::image>(enemy, texture);
+  registry.assign<components::image>(enemy, sprite->value);
   registry.assign<components::collision_mask>(enemy, COLLISION_MASK_ENEMIES);
   registry.assign<components::draw_order>(enemy, 1);
-  registry.assign<components::entity_behavior>(enemy, new BossBehavior());
   return enemy;
 }
 
+/**
+ * The boss sweeps the top of the level back and forth, stopping at five
+ * points to fire twice at the player, if the player is right below it
+ */
+static script boss_script(const components::bullet_pattern_id pattern)
+{
+    const float stops[] = {100.f, 210.f, 320.f, 430.f, 540.f};
+    const int last = 4;
+
+    for(int step = 0;; ++step)
+    {
+        // 0 1 2 3 4 3 2 1 0 1 ...
+        const int cycle = step % (last * 2);
+        const int stop = cycle <= last ? cycle : last * 2 - cycle;
+
+        co_await scripts::move_to(stops[stop], 50.f, 50.f);
+        co_await scripts::fire(pattern, true);
+        co_await scripts::wait(0.5f);
+        co_await scripts::fire(pattern, true);
+        co_await scripts::wait(0.5f);
+    }
+}
+
 void create_random_enemies(const float end_y,
-			   entt::registry& registry)
+			   const unsigned int seed,
+			   LevelStreamer& level)
 {
-    std::random_device rd;
-    std::mt19937 rand_engine(rd());
+    const Uint32 enemy = level.add_kind(create_enemy_entity);
+    std::mt19937 rand_engine(seed);
     std::uniform_real_distribution<> dist_x(0.f, 640.f);
     std::uniform_real_distribution<> dist_y(30.f, 100.f);
 
@@ -112,7 +143,7 @@ void create_random_enemies(const float end_y,
     while(y < end_y)
     {
 	int x = dist_x(rand_engine);
-	create_enemy_entity(x, y, registry);
+	level.add(enemy, x, y);
 	y += dist_y(rand_engine);
     }
 }
@@ -120,15 +151,13 @@ void create_random_enemies(const float end_y,
 entt::entity create_background(entt::registry& registry)
 {
     auto bg = registry.create();
-    SDL_Texture* texture = Resources::get_texture("background"_hs)->value;
+    auto sprite = Resources::get_texture("background"_hs);
 
     registry.assign<components::position>(bg, 320.f, 600.f);
     registry.assign<components::world_position>(bg);
-    registry.assign<components::source_rect>(
-            bg,
-            components::source_rect::from_texture(texture));
+    registry.assign<components::source_rect>(bg, sprite->rect);
     registry.assign<components::destination_rect>(bg);
-    registry.assign<components::image>(bg, texture);
+    registry.assign<components::image>(bg, sprite->value);
     registry.assign<components::draw_order>(bg, 0);
 
     return bg;
@@ -139,33 +168,319 @@ entt::entity create_camera(const components::position position,
 {
     auto camera = registry.create();
     registry.assign<components::position>(camera, position);
+    registry.assign<components::previous_position>(camera, position.x, position.y);
     registry.assign<components::velocity>(camera, 0.f, -1.f, 30.f);
     return camera;
 }
 
 void load_resources(SDL_Renderer* renderer)
 {
+    // images are decoded and animations parsed on worker threads,
+    // textures are uploaded here as soon as they are ready
+    WorkStealingPool pool;
+    ResourceLoader loader(pool);
+
+    // sprites share atlas textures so that they are drawn in few
+    // batches, the background keeps its own texture
+    loader.pack_small_textures(256);
+
+    // the packed assets built by sciuter_pack are preferred, loose
+    // files are the fallback while working on the assets
+    AssetPack pack;
+    if(pack.open(ASSET_PACK_PATH))
+    {
+        loader.load_pack(pack);
+    }
+    else
+    {
+        loader.load_texture("background"_hs, "resources/images/background.png");
+        loader.load_texture("player"_hs, "resources/images/player.png");
+        loader.load_texture("ufo"_hs, "resources/images/ufo.png");
+        loader.load_texture("boss"_hs, "resources/images/boss.png");
+        loader.load_texture("bullet"_hs, "resources/images/bullet.png");
+        loader.load_texture("bullet-enemy"_hs, "resources/images/bullet-enemy.png");
+        loader.load_texture("bullet-enemy-small"_hs, "resources/images/bullet-enemy-small.png");
+
+        loader.load_animations("player-animations"_hs,
+                               "resources/images/player.json");
+        loader.load_animations("ufo-animations"_hs,
+                               "resources/images/ufo.json");
+    }
+
+    loader.finish(renderer);
+
+    // animation frames follow their texture into the atlas
+    Resources::bind_animations("player-animations"_hs, "player"_hs);
+    Resources::bind_animations("ufo-animations"_hs, "ufo"_hs);
+
+    ufo_clip = Resources::make_animation_clip("ufo-animations"_hs, "ufo", .5f);
+    ufo_texture = Resources::get_texture("ufo"_hs)->value;
+}
+
+/**
+ * The simulation systems in their sequential order, with what they read
+ * and write; systems creating, destroying or (un)parking entities are
+ * exclusive. Keep the declarations in sync with the system bodies, an
+ * access left out lets two systems race.
+ * Exclusive systems and the chain of destination_rect writers leave
+ * little to overlap, so the systems doing per entity work also split
+ * their entities in ranges over the workers.
+ */
+static void schedule_systems(GameState& state)
+{
+    using namespace components;
+    entt::registry& registry = state.registry;
+    SystemScheduler& systems = state.systems;
+
+    // views create missing pools, which concurrent systems can't do
+    registry.prepare<position, previous_position, velocity, timer,
+		     animation, source_rect, destination_rect, world_position,
+		     collision_mask, damage, energy, bullet_slot,
+		     inactive, culled, streamed, boss_behavior, gamepad,
+		     draw_order, image>();
+    boss_behavior_group(registry);
+
+    systems.add("store_previous_positions", [&state](const float) {
+	store_previous_positions(state.registry, state.workers.get()); })
+	.reads<position, inactive>()
+	.writes<previous_position>();
+    systems.add("update_timers", [&state](const float dt) {
+	state.timers.update(dt); })
+	.writes<timer, TimerWheel>();
+    systems.add("handle_gamepad", [&state](const float) {
+	handle_gamepad(state.input, state.keyboard, state.registry); })
+	.writes<gamepad, velocity, InputRecording>();
+    // spawning bullets creates entities, only exclusive systems can
+    systems.add("fire_player_bullets", [&state](const float) {
+	fire_player_bullets(state.bullets, state.registry); })
+	.exclusive();
+    systems.add("update_behaviors", [&registry](const float dt) {
+	update_behaviors(dt, registry); })
+	.reads<boss_behavior, position>()
+	.writes<velocity>();
+    systems.add("update_animations", [&registry](const float dt) {
+	update_animations(dt, registry); })
+	.reads<culled>()
+	.writes<animation, source_rect>();
+    systems.add("update_linear_velocity", [&state](const float dt) {
+	update_linear_velocity(dt, state.registry, state.workers.get()); })
+	.reads<velocity, bullet_slot>()
+	.writes<position>();
+    // the pool bullets, moved by its BulletStore
+    systems.add("update_bullets", [&state](const float dt) {
+	state.bullets.update(dt, state.commands, state.registry); })
+	.writes<position, destination_rect, BulletPool, CommandBuffer>();
+    systems.add("stream_level", [&state](const float) {
+	state.level.update(state.registry.get<position>(state.camera),
+			   state.screen_rect, state.commands, state.registry); })
+	.exclusive();
+    // the culled tag reorders the pools owned by the render group
+    systems.add("cull_offscreen", [&state](const float) {
+	cull_offscreen(state.camera, state.screen_rect, CULL_MARGIN, state.registry); })
+	.reads<world_position, position>()
+	.writes<culled, draw_order, image, source_rect, destination_rect,
+		RenderOrder>();
+    systems.add("update_destination_rect", [&state](const float) {
+	update_destination_rect(state.registry, state.workers.get()); })
+	.reads<position, source_rect, bullet_slot, culled>()
+	.writes<destination_rect>();
+    systems.add("apply_camera_transformation", [&state](const float) {
+	apply_camera_transformation(state.camera, state.registry); })
+	.reads<world_position, previous_position, culled>()
+	.writes<position, destination_rect>();
+    systems.add("resolve_collisions", [&state](const float) {
+	resolve_collisions(state.collision_grid, state.commands, state.registry); })
+	.reads<destination_rect, collision_mask, damage, inactive, culled>()
+	.writes<energy, SpatialGrid, CommandBuffer>();
+
+    systems.add("update_scripts", [&state](const float dt) {
+	state.scripts.update(dt); })
+	.exclusive();
+
+    // sync point: apply the structural changes requested by the systems
+    systems.add("flush_commands", [&state](const float) {
+	state.commands.flush(state.registry); })
+	.exclusive();
+}
+
+GameState::GameState(const SDL_Rect& screen, const size_t threads)
+    : render_order(registry),
+      timers(registry),
+      screen_rect(screen),
+      collision_grid(screen),
+      commands(&frame_arena),
+      bullets(registry, screen),
+      scripts(patterns, bullets, registry)
+{
+    schedule_systems(*this);
+
+    if(threads != 1)
+    {
+	workers = std::make_unique<WorkStealingPool>(threads);
+    }
+}
+
+void create_scene(const unsigned int seed, GameState& state)
+{
+    entt::registry& registry = state.registry;
+
+    state.player = create_player_entity(registry);
+
+    // a fan of 9 bullets aimed at the player, in two waves
+    bullet_pattern boss_pattern;
+    boss_pattern.shape = pattern_shape::fan;
+    boss_pattern.count = 9;
+    boss_pattern.spread = 2.4f;
+    boss_pattern.speed = 80.f;
+    boss_pattern.waves = 2;
+    boss_pattern.speed_step = 20.f;
+    boss_pattern.aimed = true;
+
+    auto boss = create_boss_entity(320.f, 50.f, state.player, registry);
+    state.scripts.start(boss, boss_script(state.patterns.add(boss_pattern)));
+    create_random_enemies(1300.f, seed, state.level);
+
+    create_background(registry);
+
+    state.camera = create_camera({0, 1200 - 480}, registry);
+    // enemies in view from the first frame
+    state.level.update(registry.get<components::position>(state.camera),
+		       state.screen_rect, state.commands, registry);
+
+    auto bullet = Resources::get_texture("bullet"_hs);
+    auto bullet_enemy = Resources::get_texture("bullet-enemy"_hs);
+    state.bullets.set_prototype(COLLISION_MASK_ENEMIES,
+				bullet->value, bullet->rect, 10);
+    state.bullets.set_prototype(COLLISION_MASK_PLAYER,
+				bullet_enemy->value, bullet_enemy->rect, 10);
+    state.bullets.reserve(512, registry);
+
+    // the commands live in the frame arena, they can't wait for the
+    // first tick if the first frames have none
+    state.commands.flush(registry);
+}
+
+bool start_input(const InputOptions& options,
+                 unsigned int& seed,
+                 int& tick_rate,
+                 GameState& state)
+{
+    if(!options.replay_path.empty())
+    {
+	if(!state.input.load(options.replay_path))
+	{
+	    return false;
+	}
+	if(static_cast<Uint32>(tick_rate) != state.input.get_tick_rate())
+	{
+	    SDL_Log("replaying at the recorded tick rate of %u",
+		    state.input.get_tick_rate());
+	}
+	seed = state.input.get_seed();
+	tick_rate = state.input.get_tick_rate();
+    }
+    else if(!options.record_path.empty())
+    {
+	state.input.start_recording(seed, tick_rate);
+    }
+    return true;
+}
+
+bool finish_input(const InputOptions& options, const GameState& state)
+{
+    if(state.input.get_mode() != InputRecording::mode::record)
+    {
+	return true;
+    }
+    return state.input.save(options.record_path);
+}
+
+void SystemTimings::add(const char* name, const Uint64 counter_ticks)
+{
+    if(m_next == m_systems.size())
+    {
+	m_systems.push_back({name, 0});
+    }
+    m_systems[m_next++].counter_ticks += counter_ticks;
+}
+
+void update_simulation(const float dt, GameState& state, SystemTimings* timings)
+{
+    SCIUTER_PROFILE_ZONE("update_simulation");
+
+    // SDL wants its events handled on the main thread, the systems may
+    // run anywhere: they get a copy of the keys, already up to date
+    // with the events polled by the main loop
+    int key_count = 0;
+    const Uint8* keys = SDL_GetKeyboardState(&key_count);
+    state.keyboard.assign(keys, keys + key_count);
+
+    state.systems.run(dt, state.workers.get());
+
+    if(nullptr != timings)
+    {
+	timings->begin_tick();
+	for(size_t i = 0; i < state.systems.size(); ++i)
+	{
+	    timings->add(state.systems.get_name(i), state.systems.get_counter_ticks(i));
+	}
+    }
+}
 
-    Resources::load_texture(
-	"background"_hs,
-	"resources/images/background.png",
-	renderer);
-    Resources::load_texture("player"_hs, "resources/images/player.png", renderer);
-    Resources::load_texture("ufo"_hs, "resources/images/ufo.png", renderer);
-    Resources::load_texture("boss"_hs, "resources/images/boss.png", renderer);
-    Resources::load_texture("bullet"_hs, "resources/images/bullet.png", renderer);
-    Resources::load_texture("bullet-enemy"_hs, "resources/images/bullet-enemy.png", renderer);
-    Resources::load_texture("bullet-enemy-small"_hs, "resources/images/bullet-enemy-small.png", renderer);
+void update_render_rects(const float alpha, GameState& state)
+{
+    SCIUTER_PROFILE_ZONE("update_render_rects");
+
+    // rects drawn this frame are rebuilt from the positions
+    // interpolated between the last two ticks
+    update_destination_rect(state.registry);
+    interpolate_destination_rect(alpha, state.registry);
+    apply_camera_transformation(state.camera, state.registry, alpha);
+    update_transformations(state.registry);
+}
+
+void end_frame(GameState& state)
+{
+    // commands recorded out of a tick are applied now, the swap could
+    // otherwise rewind them before any tick flushes them
+    state.commands.flush(state.registry);
+
+    SCIUTER_PROFILE_COUNTER("frame_arena allocations",
+			    state.frame_arena.get_allocations());
+    SCIUTER_PROFILE_COUNTER("frame_arena bytes", state.frame_arena.get_bytes());
+    state.frame_arena.swap();
+}
+
+/**
+ * Texture the scene is drawn into, sampled with nearest neighbour by
+ * the copy to the window; NULL if the renderer can't draw to textures
+ */
+static SDL_Texture* create_render_target(SDL_Renderer* renderer)
+{
+    if(!SDL_RenderTargetSupported(renderer))
+    {
+        SDL_Log("Render targets not supported, scaling every sprite");
+        return nullptr;
+    }
 
-    Resources::load_animations("player-animations"_hs,
-			       "resources/images/player.json");
-    Resources::load_animations("ufo-animations"_hs,
-			       "resources/images/ufo.json");
+    // the scale quality of a texture is fixed when it is created
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    SDL_Texture* target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+					    SDL_TEXTUREACCESS_TARGET,
+					    AREA_WIDTH, AREA_HEIGHT);
+    if(nullptr == target)
+    {
+        SDL_Log("Render target could not be created! SDL Error: %s", SDL_GetError());
+    }
+    return target;
 }
 
-void main_loop(SDL_Window* window, const int scale)
+void main_loop(SDL_Window* window, const int tick_rate,
+               const size_t threads, const InputOptions& input)
 {
-    unsigned int old_time = SDL_GetTicks();
+    const double counter_frequency = SDL_GetPerformanceFrequency();
+    Uint64 old_counter = SDL_GetPerformanceCounter();
+    double accumulator = 0.0;
     bool quit = false;
     SDL_Event e;
 
@@ -182,20 +497,34 @@ void main_loop(SDL_Window* window, const int scale)
     //Initialize renderer color
     SDL_SetRenderDrawColor( renderer, 0xFF, 0xFF, 0xFF, 0xFF );
 
-    entt::registry registry;
-
-    auto player = create_player_entity(registry);
-
-    create_boss_entity(320.f, 50.f, player, registry);
-    create_random_enemies(1300.f, registry);
+    // without a target texture the renderer scales every draw call to
+    // the window by itself
+    SDL_Texture* render_target = create_render_target(renderer);
+    if(nullptr == render_target)
+    {
+        SDL_RenderSetLogicalSize(renderer, AREA_WIDTH, AREA_HEIGHT);
+    }
 
-    create_background(registry);
+    GameState state({0, 0, AREA_WIDTH, AREA_HEIGHT}, threads);
+    unsigned int seed = std::random_device()();
+    int state_tick_rate = tick_rate;
+    if(!start_input(input, seed, state_tick_rate, state))
+    {
+        if(nullptr != render_target) SDL_DestroyTexture( render_target );
+        SDL_DestroyRenderer( renderer );
+        return;
+    }
+    create_scene(seed, state);
 
-    SDL_Rect screen_rect = {0, 0, AREA_WIDTH, AREA_HEIGHT};
-    auto camera = create_camera({0, 1200 - 480}, registry);
+    // the simulation advances in fixed steps of tick_time, rendering
+    // happens as often as possible and interpolates between the last
+    // two ticks
+    const float tick_time = 1.f / state_tick_rate;
 
     while( !quit )
     {
+        SCIUTER_PROFILE_ZONE("frame");
+
         while( SDL_PollEvent( &e ) != 0 )
         {
             //User requests quit
@@ -216,30 +545,56 @@ void main_loop(SDL_Window* window, const int scale)
             }
         }
 
-        unsigned int now_time = SDL_GetTicks();
-        float dt = (now_time - old_time) * 0.001f;
-        old_time = now_time;
+        const Uint64 now_counter = SDL_GetPerformanceCounter();
+        accumulator += (now_counter - old_counter) / counter_frequency;
+        old_counter = now_counter;
+
+        // after a hitch drop the time that can't be caught up, instead
+        // of stalling on a long burst of ticks
+        if(accumulator > MAX_FRAME_TIME) accumulator = MAX_FRAME_TIME;
 
-	update_timers(dt, registry);
-        handle_gamepad(screen_rect, registry);
-	update_behaviors(dt, registry);
+        while(accumulator >= tick_time)
+        {
+            update_simulation(tick_time, state);
+            accumulator -= tick_time;
+        }
 
-        update_animations(dt, registry);
-        update_linear_velocity(dt, registry);
-        update_destination_rect(registry);
-        apply_camera_transformation(camera, registry);
-        resolve_collisions(registry);
-        check_boundaries(registry);
-        update_shot_to_target_behaviour(screen_rect, registry);
-        update_transformations(registry);
+        // a replay ends with its recording
+        if(state.input.get_mode() == InputRecording::mode::replay &&
+           state.input.finished())
+        {
+            quit = true;
+        }
+
+        update_render_rects(accumulator / tick_time, state);
 
         //Clear screen
+        SDL_SetRenderTarget( renderer, render_target );
         SDL_RenderClear( renderer );
 
-        render_sprites(renderer, scale, registry);
+        {
+            SCIUTER_PROFILE_ZONE("render_sprites");
+            render_sprites(renderer, state.batch, state.render_order, state.registry);
+        }
+
+        // a single upscaled copy, sprites are rasterized at the scene
+        // resolution whatever the window size
+        if(nullptr != render_target)
+        {
+            SCIUTER_PROFILE_ZONE("upscale");
+            SDL_SetRenderTarget( renderer, nullptr );
+            SDL_RenderCopy( renderer, render_target, nullptr, nullptr );
+        }
 
         //Update screen
-        SDL_RenderPresent( renderer );
+        {
+            SCIUTER_PROFILE_ZONE("SDL_RenderPresent");
+            SDL_RenderPresent( renderer );
+        }
+
+        end_frame(state);
     }
+    finish_input(input, state);
+    if(nullptr != render_target) SDL_DestroyTexture( render_target );
     SDL_DestroyRenderer( renderer );
 }
@@ -0,0 +1,160 @@
+/**
+ * Headless driver: runs the full system pipeline with no window and no
+ * GPU, to measure simulation performance on machines without a display.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <sciuter/game.hpp>
+#include <sciuter/profiler.hpp>
+#include <sciuter/systems.hpp>
+
+/**
+ * FNV-1a over the positions and energy of every entity: two runs
+ * reaching the same state print the same checksum
+ */
+static Uint64 state_checksum(entt::registry& registry)
+{
+    Uint64 hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, const size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for(size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    registry.each([&](const entt::entity entity) {
+        mix(&entity, sizeof(entity));
+        if(auto position = registry.try_get<components::position>(entity))
+        {
+            mix(&position->x, sizeof(position->x));
+            mix(&position->y, sizeof(position->y));
+        }
+        if(auto energy = registry.try_get<components::energy>(entity))
+        {
+            mix(&energy->value, sizeof(energy->value));
+        }
+    });
+    return hash;
+}
+
+int run_headless(const HeadlessOptions& options)
+{
+    if(!sdl_init_headless())
+    {
+        return 1;
+    }
+
+    // textures are still needed for sprite sizes, they live in the
+    // software renderer drawing into this surface
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(
+        0, AREA_WIDTH, AREA_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+    if(nullptr == renderer)
+    {
+        SDL_Log("Software renderer could not be created! SDL Error: %s",
+                SDL_GetError());
+        SDL_FreeSurface(target);
+        sdl_quit(nullptr);
+        return 1;
+    }
+
+    load_resources(renderer);
+
+    SystemTimings timings;
+    Uint64 render_ticks = 0;
+    const double counter_frequency = SDL_GetPerformanceFrequency();
+    int result = 0;
+
+    {
+        GameState state({0, 0, AREA_WIDTH, AREA_HEIGHT}, options.threads);
+        unsigned int seed = options.seed;
+        int tick_rate = options.tick_rate;
+        if(!start_input(options.input, seed, tick_rate, state))
+        {
+            SDL_DestroyRenderer(renderer);
+            SDL_FreeSurface(target);
+            sdl_quit(nullptr);
+            return 1;
+        }
+        create_scene(seed, state);
+
+        const float tick_time = 1.f / tick_rate;
+        int ticks = options.ticks;
+        if(0 == ticks && state.input.get_mode() == InputRecording::mode::replay)
+        {
+            ticks = state.input.get_status_count();
+        }
+
+        size_t peak_allocations = 0;
+        size_t peak_bytes = 0;
+        const Uint64 start = SDL_GetPerformanceCounter();
+
+        for(int tick = 0; tick < ticks; ++tick)
+        {
+            update_simulation(tick_time, state, &timings);
+
+            if(options.render)
+            {
+                const Uint64 render_start = SDL_GetPerformanceCounter();
+                update_render_rects(1.f, state);
+                SDL_RenderClear(renderer);
+                {
+                    SCIUTER_PROFILE_ZONE("render_sprites");
+                    render_sprites(renderer, state.batch, state.render_order,
+                                   state.registry);
+                }
+                {
+                    SCIUTER_PROFILE_ZONE("SDL_RenderPresent");
+                    SDL_RenderPresent(renderer);
+                }
+                render_ticks += SDL_GetPerformanceCounter() - render_start;
+            }
+
+            // every tick is a frame here
+            peak_allocations = std::max(peak_allocations,
+                                        state.frame_arena.get_allocations());
+            peak_bytes = std::max(peak_bytes, state.frame_arena.get_bytes());
+            end_frame(state);
+        }
+
+        const double elapsed = (SDL_GetPerformanceCounter() - start) / counter_frequency;
+
+        printf("seed %u, %d ticks in %.3f s: %.1f ticks/s\n",
+               seed, ticks, elapsed, ticks / std::max(elapsed, 1e-9));
+        printf("%-32s %12s %12s %8s\n", "system", "total ms", "us/tick", "share");
+
+        auto print_row = [&](const char* name, const Uint64 counter_ticks) {
+            const double seconds = counter_ticks / counter_frequency;
+            printf("%-32s %12.3f %12.3f %7.1f%%\n",
+                   name, seconds * 1000.0,
+                   seconds * 1e6 / std::max(ticks, 1),
+                   100.0 * seconds / std::max(elapsed, 1e-9));
+        };
+
+        for(auto& system : timings.get_systems())
+        {
+            print_row(system.name, system.counter_ticks);
+        }
+        if(options.render)
+        {
+            print_row("render_sprites", render_ticks);
+        }
+        printf("entities alive at the end: %zu\n", state.registry.alive());
+        printf("frame arena peak: %zu allocations, %zu bytes in a frame\n",
+               peak_allocations, peak_bytes);
+        printf("state checksum: %016llx\n",
+               static_cast<unsigned long long>(state_checksum(state.registry)));
+
+        if(!finish_input(options.input, state))
+        {
+            result = 1;
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    sdl_quit(nullptr);
+
+    return result;
+}
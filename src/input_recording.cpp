@@ -0,0 +1,110 @@
+#include <cstring>
+#include <fstream>
+#include <sciuter/input_recording.hpp>
+
+void InputRecording::start_recording(const Uint32 seed, const Uint32 tick_rate)
+{
+    m_mode = mode::record;
+    m_seed = seed;
+    m_tick_rate = tick_rate;
+    m_status_count = 0;
+    m_runs.clear();
+}
+
+void InputRecording::push(const components::ActionStatus status)
+{
+    if(!m_runs.empty() && m_runs.back().status == status)
+    {
+        m_runs.back().count += 1;
+    }
+    else
+    {
+        m_runs.push_back({status, 1});
+    }
+    m_status_count += 1;
+}
+
+bool InputRecording::save(const std::string& path) const
+{
+    recording_header header;
+    memcpy(header.magic, RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+    header.version = RECORDING_VERSION;
+    header.seed = m_seed;
+    header.tick_rate = m_tick_rate;
+    header.status_count = m_status_count;
+    header.run_count = m_runs.size();
+
+    std::ofstream output(path, std::ios::binary);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(m_runs.data()),
+                 m_runs.size() * sizeof(status_run));
+    if(!output)
+    {
+        SDL_Log("Unable to write input recording %s", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool InputRecording::load(const std::string& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    recording_header header;
+
+    if(!input.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+       memcmp(header.magic, RECORDING_MAGIC, sizeof(RECORDING_MAGIC)) != 0 ||
+       header.version != RECORDING_VERSION)
+    {
+        SDL_Log("%s is not an input recording", path.c_str());
+        return false;
+    }
+
+    // run_count comes from the file, check it against the bytes left
+    // before sizing anything with it
+    const std::streampos runs_start = input.tellg();
+    input.seekg(0, std::ios::end);
+    const std::streamoff runs_size = input.tellg() - runs_start;
+    input.seekg(runs_start);
+    if(runs_size < 0 ||
+       (Uint64)header.run_count * sizeof(status_run) > (Uint64)runs_size)
+    {
+        SDL_Log("Input recording %s is truncated", path.c_str());
+        return false;
+    }
+
+    std::vector<status_run> runs(header.run_count);
+    if(!input.read(reinterpret_cast<char*>(runs.data()),
+                   runs.size() * sizeof(status_run)))
+    {
+        SDL_Log("Input recording %s is truncated", path.c_str());
+        return false;
+    }
+
+    m_mode = mode::replay;
+    m_seed = header.seed;
+    m_tick_rate = header.tick_rate;
+    m_status_count = header.status_count;
+    m_runs.swap(runs);
+    m_position = 0;
+    m_run = 0;
+    m_run_offset = 0;
+    return true;
+}
+
+components::ActionStatus InputRecording::next()
+{
+    // move to the run holding the next status
+    while(m_run < m_runs.size() && m_run_offset >= m_runs[m_run].count)
+    {
+        ++m_run;
+        m_run_offset = 0;
+    }
+    if(finished() || m_run >= m_runs.size())
+    {
+        return 0;
+    }
+
+    ++m_position;
+    ++m_run_offset;
+    return m_runs[m_run].status;
+}
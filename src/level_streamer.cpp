@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <sciuter/level_streamer.hpp>
+
+Uint32 LevelStreamer::add_kind(const spawn_function spawn)
+{
+    m_kinds.push_back(spawn);
+    return m_kinds.size() - 1;
+}
+
+void LevelStreamer::add(const Uint32 kind, const float x, const float y)
+{
+    m_records.push_back({x, y, kind});
+    m_sorted = false;
+}
+
+void LevelStreamer::update(const components::position& camera,
+                           const SDL_Rect& viewport,
+                           CommandBuffer& commands,
+                           entt::registry& registry)
+{
+    if(!m_sorted)
+    {
+        // records added after the start are sorted with the pending ones,
+        // equal y keep the order they were added in
+        std::stable_sort(m_records.begin() + m_next, m_records.end(),
+                         [](const spawn_record& a, const spawn_record& b) {
+                             return a.y > b.y;
+                         });
+        m_sorted = true;
+    }
+
+    const float top = camera.y + viewport.y - m_lookahead;
+    const float bottom = camera.y + viewport.y + viewport.h + m_despawn_distance;
+
+    // records already behind the camera are skipped, as when the level
+    // starts in its middle
+    for(; m_next < m_records.size() && m_records[m_next].y >= top; ++m_next)
+    {
+        const spawn_record& record = m_records[m_next];
+        if(record.y <= bottom)
+        {
+            auto entity = m_kinds[record.kind](record.x, record.y, registry);
+            registry.assign<components::streamed>(entity);
+        }
+    }
+
+    auto view = registry.view<
+        components::streamed,
+        components::position>();
+
+    for(auto entity: view) {
+        if(view.get<components::position>(entity).y > bottom)
+        {
+            commands.destroy(entity);
+        }
+    }
+}
@@ -2,17 +2,106 @@
  * Testing EnTT ECS library using SDL2 as the media library
  * Implementing a shmup to have fun while I experiment
  */
+#include <cstdlib>
 #include <random>
 #include <string>
 #include <sciuter/sdl.hpp>
 #include <sciuter/game.hpp>
-
-//game dimension constants
-const int AREA_WIDTH = 640;
-const int AREA_HEIGHT = 480;
+#include <sciuter/profiler.hpp>
 
 int main( int argc, char* args[] )
 {
+    int tick_rate = 60;
+    int threads = 1;
+    bool headless = false;
+    HeadlessOptions headless_options;
+    InputOptions input_options;
+    bool ticks_set = false;
+    std::string trace_path;
+
+    for(int i = 1; i < argc; ++i)
+    {
+	const std::string arg = args[i];
+	if(arg == "--tick-rate" && i + 1 < argc)
+	{
+	    tick_rate = std::atoi(args[++i]);
+	}
+	else if(arg == "--threads" && i + 1 < argc)
+	{
+	    threads = std::atoi(args[++i]);
+	}
+	else if(arg == "--headless")
+	{
+	    headless = true;
+	}
+	else if(arg == "--seed" && i + 1 < argc)
+	{
+	    headless_options.seed = std::strtoul(args[++i], nullptr, 10);
+	}
+	else if(arg == "--ticks" && i + 1 < argc)
+	{
+	    headless_options.ticks = std::atoi(args[++i]);
+	    ticks_set = true;
+	}
+	else if(arg == "--render")
+	{
+	    headless_options.render = true;
+	}
+	else if(arg == "--record" && i + 1 < argc)
+	{
+	    input_options.record_path = args[++i];
+	}
+	else if(arg == "--replay" && i + 1 < argc)
+	{
+	    input_options.replay_path = args[++i];
+	}
+	else if(arg == "--trace" && i + 1 < argc)
+	{
+	    trace_path = args[++i];
+	}
+	else
+	{
+	    SDL_Log("usage: %s [--tick-rate ticks_per_second] [--threads count] "
+		    "[--record file | --replay file] [--trace file] "
+		    "[--headless [--seed seed] [--ticks ticks] [--render]]",
+		    args[0]);
+	    return 1;
+	}
+    }
+
+    if(tick_rate <= 0)
+    {
+	SDL_Log("tick rate must be positive");
+	return 1;
+    }
+
+    if(threads < 0)
+    {
+	SDL_Log("thread count can't be negative");
+	return 1;
+    }
+
+    if(!input_options.record_path.empty() && !input_options.replay_path.empty())
+    {
+	SDL_Log("can't record and replay at the same time");
+	return 1;
+    }
+
+    if(headless)
+    {
+	headless_options.tick_rate = tick_rate;
+	headless_options.threads = threads;
+	headless_options.input = input_options;
+	// a replay runs to its end unless told otherwise
+	if(!ticks_set && !input_options.replay_path.empty())
+	{
+	    headless_options.ticks = 0;
+	}
+	const int result = run_headless(headless_options);
+	if(!trace_path.empty()) Profiler::write_chrome_trace(trace_path);
+	return result;
+    }
+
     SDL_Window* window = sdl_init(AREA_WIDTH, AREA_HEIGHT);
 
     if( NULL == window)
@@ -40,7 +129,9 @@ int main( int argc, char* args[] )
     SDL_SetWindowSize(window, AREA_WIDTH * scale, AREA_HEIGHT * scale);
     SDL_SetWindowPosition(window, SDL_WINDOWPOS_CENTERED, 10);
 
-    main_loop(window, scale);
+    main_loop(window, tick_rate, threads, input_options);
+
+    if(!trace_path.empty()) Profiler::write_chrome_trace(trace_path);
 
     //Quit SDL subsystems
     sdl_quit(window);
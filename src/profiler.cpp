@@ -0,0 +1,107 @@
+#include <fstream>
+#include <iomanip>
+#include <sciuter/profiler.hpp>
+
+Profiler Profiler::s_instance;
+
+// small sequential ids are easier to read in the trace viewer than the
+// std::thread ids
+static uint32_t current_thread_id()
+{
+    static std::atomic<uint32_t> next_id{1};
+    thread_local const uint32_t id = next_id.fetch_add(1);
+    return id;
+}
+
+Profiler::Profiler() : m_head(0)
+{
+    // the buffer is not worth its memory when zones are compiled out
+    if(enabled())
+    {
+        m_slots.reset(new slot[CAPACITY]);
+        for(size_t i = 0; i < CAPACITY; ++i)
+        {
+            m_slots[i].sequence.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+const bool Profiler::enabled()
+{
+#ifdef SCIUTER_PROFILER
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Profiler::_record(const char* name, const Uint64 start, const Uint64 end,
+                       const bool counter)
+{
+    if(!m_slots) return;
+
+    const uint64_t index = m_head.fetch_add(1, std::memory_order_relaxed);
+    slot& target = m_slots[index & (CAPACITY - 1)];
+
+    target.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    target.event = {name, start, end, current_thread_id(), counter};
+    target.sequence.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::_write_chrome_trace(const std::string& path) const
+{
+    if(!m_slots)
+    {
+        SDL_Log("Profiler zones are compiled out, build with SCIUTER_PROFILER");
+        return false;
+    }
+
+    std::ofstream output(path);
+    if(!output)
+    {
+        SDL_Log("Unable to write trace %s", path.c_str());
+        return false;
+    }
+
+    const double to_us = 1e6 / SDL_GetPerformanceFrequency();
+    bool first = true;
+
+    // timestamps are microseconds since the counter origin, too many
+    // digits for the default stream precision
+    output << std::fixed << std::setprecision(3);
+    output << "{\"traceEvents\":[\n";
+    for(size_t i = 0; i < CAPACITY; ++i)
+    {
+        const slot& source = m_slots[i];
+        const uint64_t sequence = source.sequence.load(std::memory_order_acquire);
+        const zone_event event = source.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if(sequence == 0 ||
+           sequence != source.sequence.load(std::memory_order_relaxed))
+        {
+            continue;
+        }
+
+        output << (first ? "" : ",\n")
+               << "{\"name\":\"" << event.name << "\"";
+        if(event.counter)
+        {
+            output << ",\"ph\":\"C\""
+                   << ",\"ts\":" << event.start * to_us
+                   << ",\"pid\":1,\"args\":{\"value\":" << event.end << "}}";
+        }
+        else
+        {
+            output << ",\"ph\":\"X\""
+                   << ",\"ts\":" << event.start * to_us
+                   << ",\"dur\":" << (event.end - event.start) * to_us
+                   << ",\"pid\":1,\"tid\":" << event.thread << "}";
+        }
+        first = false;
+    }
+    output << "\n]}\n";
+
+    return true;
+}
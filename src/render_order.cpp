@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <functional>
+#include <sciuter/render_order.hpp>
+
+RenderOrder::RenderOrder(entt::registry& registry)
+    : m_registry(registry), m_changes(INCREMENTAL_LIMIT + 1)
+{
+    registry.on_construct<components::draw_order>().connect<&RenderOrder::invalidate>(*this);
+    registry.on_replace<components::draw_order>().connect<&RenderOrder::invalidate>(*this);
+    registry.on_destroy<components::draw_order>().connect<&RenderOrder::invalidate>(*this);
+    registry.on_construct<components::image>().connect<&RenderOrder::invalidate>(*this);
+    registry.on_replace<components::image>().connect<&RenderOrder::invalidate>(*this);
+    registry.on_destroy<components::image>().connect<&RenderOrder::invalidate>(*this);
+    // pooled entities joining or leaving the group
+    registry.on_construct<components::inactive>().connect<&RenderOrder::invalidate>(*this);
+    registry.on_destroy<components::inactive>().connect<&RenderOrder::invalidate>(*this);
+    // world entities going out of view or coming back
+    registry.on_construct<components::culled>().connect<&RenderOrder::invalidate>(*this);
+    registry.on_destroy<components::culled>().connect<&RenderOrder::invalidate>(*this);
+}
+
+RenderOrder::~RenderOrder()
+{
+    m_registry.on_construct<components::draw_order>().disconnect(*this);
+    m_registry.on_replace<components::draw_order>().disconnect(*this);
+    m_registry.on_destroy<components::draw_order>().disconnect(*this);
+    m_registry.on_construct<components::image>().disconnect(*this);
+    m_registry.on_replace<components::image>().disconnect(*this);
+    m_registry.on_destroy<components::image>().disconnect(*this);
+    m_registry.on_construct<components::inactive>().disconnect(*this);
+    m_registry.on_destroy<components::inactive>().disconnect(*this);
+    m_registry.on_construct<components::culled>().disconnect(*this);
+    m_registry.on_destroy<components::culled>().disconnect(*this);
+}
+
+void RenderOrder::sort()
+{
+    if(m_changes == 0)
+    {
+        return;
+    }
+
+    if(m_changes <= INCREMENTAL_LIMIT)
+    {
+        // the group is still sorted but for a few entities, insertion
+        // sort moves just those in place
+        auto group = render_group(m_registry);
+        group.sort<components::draw_order, components::image>(
+            [](const auto& a, const auto& b) {
+                const components::draw_order a_order = std::get<0>(a);
+                const components::draw_order b_order = std::get<0>(b);
+                if(a_order != b_order) return a_order < b_order;
+                return std::less<SDL_Texture*>()(std::get<1>(a).texture,
+                                                 std::get<1>(b).texture);
+            },
+            entt::insertion_sort{});
+    }
+    else
+    {
+        counting_sort();
+    }
+
+    m_changes = 0;
+}
+
+void RenderOrder::counting_sort()
+{
+    auto group = render_group(m_registry);
+
+    if(group.empty())
+    {
+        return;
+    }
+
+    // draw orders are a small range and the textures a handful, so each
+    // (draw order, texture) pair gets its own bucket; textures are
+    // ranked by address to match the ordering of the insertion fix-up
+    m_textures.clear();
+    components::draw_order min_order = group.get<components::draw_order>(*group.begin());
+    components::draw_order max_order = min_order;
+
+    for(auto entity : group)
+    {
+        const components::draw_order order = group.get<components::draw_order>(entity);
+        SDL_Texture* texture = group.get<components::image>(entity).texture;
+        min_order = std::min(min_order, order);
+        max_order = std::max(max_order, order);
+        if(std::find(m_textures.begin(), m_textures.end(), texture) == m_textures.end())
+        {
+            m_textures.push_back(texture);
+        }
+    }
+    std::sort(m_textures.begin(), m_textures.end(), std::less<SDL_Texture*>());
+
+    const size_t texture_count = m_textures.size();
+    const size_t bucket_count = (max_order - min_order + 1) * texture_count;
+
+    auto key = [&](const entt::entity entity) {
+        const components::draw_order order = group.get<components::draw_order>(entity);
+        SDL_Texture* texture = group.get<components::image>(entity).texture;
+        const size_t rank = std::lower_bound(
+            m_textures.begin(), m_textures.end(), texture,
+            std::less<SDL_Texture*>()) - m_textures.begin();
+        return (order - min_order) * texture_count + rank;
+    };
+
+    // the group sorts a copy of its entities with the given algorithm
+    // and then rearranges its components to match, the comparison
+    // function is not needed by a counting sort
+    group.sort(
+        [](const entt::entity, const entt::entity) { return false; },
+        [&](auto first, auto last, auto) {
+            m_bucket_start.assign(bucket_count + 1, 0);
+            for(auto it = first; it != last; ++it)
+            {
+                m_bucket_start[key(*it) + 1] += 1;
+            }
+            for(size_t bucket = 1; bucket <= bucket_count; ++bucket)
+            {
+                m_bucket_start[bucket] += m_bucket_start[bucket - 1];
+            }
+            m_sorted.resize(std::distance(first, last));
+            for(auto it = first; it != last; ++it)
+            {
+                m_sorted[m_bucket_start[key(*it)]++] = *it;
+            }
+            std::copy(m_sorted.begin(), m_sorted.end(), first);
+        });
+}
@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <sciuter/atlas.hpp>
+#include <sciuter/resource_loader.hpp>
+
+// transparent pixels between atlas regions, against filtering bleed
+const int ATLAS_PADDING = 1;
+
+// pages of every loader get their own ids
+static int s_atlas_pages = 0;
+
+template<typename Type>
+static bool is_ready(std::future<Type>& future)
+{
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+texture_future ResourceLoader::load_texture(texture_id_type id, const std::string path)
+{
+    pending_texture pending{
+        id, path,
+        m_pool.submit([path] { return load_surface(path); }),
+        {}};
+    texture_future ready = pending.ready.get_future().share();
+    m_textures.push_back(std::move(pending));
+    return ready;
+}
+
+animation_future ResourceLoader::load_animations(animation_id_type id, const std::string path)
+{
+    pending_animations pending{
+        id,
+        m_pool.submit([path] { return TexturePackerAnimationLoader::load(path); }),
+        {}};
+    animation_future ready = pending.ready.get_future().share();
+    m_animations.push_back(std::move(pending));
+    return ready;
+}
+
+texture_future ResourceLoader::load_texture(texture_id_type id, const AssetPack& pack)
+{
+    const std::string name = "pack entry " + std::to_string(id);
+    pending_texture pending{
+        id, name,
+        m_pool.submit([id, name, &pack] {
+            SDL_RWops* stream = pack.open_stream(id);
+            if(nullptr == stream)
+            {
+                SDL_Log("Missing asset %s", name.c_str());
+                return (SDL_Surface*)nullptr;
+            }
+            return load_surface(stream, name);
+        }),
+        {}};
+    texture_future ready = pending.ready.get_future().share();
+    m_textures.push_back(std::move(pending));
+    return ready;
+}
+
+animation_future ResourceLoader::load_animations(animation_id_type id, const AssetPack& pack)
+{
+    pending_animations pending{
+        id,
+        m_pool.submit([id, &pack] {
+            asset found;
+            if(!pack.find(id, found))
+            {
+                SDL_Log("Missing asset pack entry %u", id);
+                return AnimationMap();
+            }
+            return BinaryAnimationLoader::load(
+                static_cast<const char*>(found.data), found.size);
+        }),
+        {}};
+    animation_future ready = pending.ready.get_future().share();
+    m_animations.push_back(std::move(pending));
+    return ready;
+}
+
+void ResourceLoader::load_pack(const AssetPack& pack)
+{
+    for(Uint32 i = 0; i < pack.get_entry_count(); ++i)
+    {
+        const pack_entry& entry = pack.get_entry(i);
+        switch(entry.type)
+        {
+            case asset_type::image:
+                load_texture(entry.id, pack);
+                break;
+            case asset_type::animations:
+                load_animations(entry.id, pack);
+                break;
+        }
+    }
+}
+
+bool ResourceLoader::poll(SDL_Renderer* renderer)
+{
+    for(auto it = m_textures.begin(); it != m_textures.end();)
+    {
+        if(!is_ready(it->surface))
+        {
+            ++it;
+            continue;
+        }
+        store_texture(*it, it->surface.get(), renderer);
+        it = m_textures.erase(it);
+    }
+
+    if(m_textures.empty())
+    {
+        pack_atlas(renderer);
+    }
+
+    for(auto it = m_animations.begin(); it != m_animations.end();)
+    {
+        if(!is_ready(it->animations))
+        {
+            ++it;
+            continue;
+        }
+        AnimationMap animations = it->animations.get();
+        it->ready.set_value(Resources::add_animations(it->id, animations));
+        it = m_animations.erase(it);
+    }
+
+    return m_textures.empty() && m_animations.empty();
+}
+
+void ResourceLoader::pack_small_textures(const int max_size, const int page_size)
+{
+    m_atlas_sprite_size = std::min(max_size, page_size - ATLAS_PADDING);
+    m_atlas_page_size = page_size;
+}
+
+void ResourceLoader::store_texture(pending_texture& pending,
+                                   SDL_Surface* surface,
+                                   SDL_Renderer* renderer)
+{
+    if(nullptr != surface &&
+       surface->w <= m_atlas_sprite_size && surface->h <= m_atlas_sprite_size)
+    {
+        m_atlas_sprites.push_back(
+            {pending.id, pending.path, surface, std::move(pending.ready)});
+        return;
+    }
+    pending.ready.set_value(
+        Resources::add_texture(pending.id, surface, pending.path, renderer));
+}
+
+void ResourceLoader::pack_atlas(SDL_Renderer* renderer)
+{
+    if(m_atlas_sprites.empty())
+    {
+        return;
+    }
+
+    // tallest first keeps the skyline flat
+    std::sort(m_atlas_sprites.begin(), m_atlas_sprites.end(),
+              [](const atlas_sprite& a, const atlas_sprite& b) {
+                  return a.surface->h != b.surface->h ?
+                      a.surface->h > b.surface->h : a.surface->w > b.surface->w;
+              });
+
+    struct page
+    {
+        SkylinePacker packer;
+        int height;
+    };
+    std::vector<page> pages;
+    std::vector<size_t> sprite_pages(m_atlas_sprites.size());
+    std::vector<SDL_Rect> sprite_rects(m_atlas_sprites.size());
+
+    for(size_t i = 0; i < m_atlas_sprites.size(); ++i)
+    {
+        const SDL_Surface* surface = m_atlas_sprites[i].surface;
+        SDL_Rect rect;
+        size_t index = 0;
+
+        while(index < pages.size() &&
+              !pages[index].packer.insert(surface->w + ATLAS_PADDING,
+                                          surface->h + ATLAS_PADDING, rect))
+        {
+            ++index;
+        }
+        if(index == pages.size())
+        {
+            pages.push_back({SkylinePacker(m_atlas_page_size, m_atlas_page_size), 0});
+            pages.back().packer.insert(surface->w + ATLAS_PADDING,
+                                       surface->h + ATLAS_PADDING, rect);
+        }
+
+        sprite_pages[i] = index;
+        sprite_rects[i] = {rect.x, rect.y, surface->w, surface->h};
+        pages[index].height = std::max(pages[index].height, rect.y + rect.h);
+    }
+
+    for(size_t index = 0; index < pages.size(); ++index)
+    {
+        // pages are only as tall as their content
+        SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(
+            0, m_atlas_page_size, pages[index].height, 32, SDL_PIXELFORMAT_RGBA32);
+
+        if(nullptr == atlas)
+        {
+            // the sprites of the page keep a texture each
+            SDL_Log("Unable to create an atlas page, SDL Error: %s", SDL_GetError());
+            for(size_t i = 0; i < m_atlas_sprites.size(); ++i)
+            {
+                if(sprite_pages[i] == index)
+                {
+                    atlas_sprite& sprite = m_atlas_sprites[i];
+                    sprite.ready.set_value(Resources::add_texture(
+                        sprite.id, sprite.surface, sprite.path, renderer));
+                    // freed by add_texture
+                    sprite.surface = nullptr;
+                }
+            }
+            continue;
+        }
+
+        for(size_t i = 0; i < m_atlas_sprites.size(); ++i)
+        {
+            if(sprite_pages[i] == index)
+            {
+                // copy the alpha channel instead of blending it
+                SDL_Rect destination = sprite_rects[i];
+                SDL_SetSurfaceBlendMode(m_atlas_sprites[i].surface, SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(m_atlas_sprites[i].surface, nullptr,
+                                atlas, &destination);
+            }
+        }
+
+        const std::string name = "atlas:" + std::to_string(s_atlas_pages++);
+        const texture_id_type atlas_id = entt::hashed_string::to_value(name.c_str());
+        Resources::add_texture(atlas_id, atlas, name, renderer);
+
+        for(size_t i = 0; i < m_atlas_sprites.size(); ++i)
+        {
+            if(sprite_pages[i] == index)
+            {
+                m_atlas_sprites[i].ready.set_value(
+                    Resources::add_texture_region(
+                        m_atlas_sprites[i].id, atlas_id, sprite_rects[i]));
+            }
+        }
+    }
+
+    for(auto& sprite : m_atlas_sprites)
+    {
+        SDL_FreeSurface(sprite.surface);
+    }
+    m_atlas_sprites.clear();
+}
+
+void ResourceLoader::finish(SDL_Renderer* renderer)
+{
+    // uploads happen in request order while the workers keep decoding
+    // the following images
+    for(auto& pending : m_textures)
+    {
+        store_texture(pending, pending.surface.get(), renderer);
+    }
+    m_textures.clear();
+    pack_atlas(renderer);
+
+    for(auto& pending : m_animations)
+    {
+        AnimationMap animations = pending.animations.get();
+        pending.ready.set_value(Resources::add_animations(pending.id, animations));
+    }
+    m_animations.clear();
+}
@@ -0,0 +1,184 @@
+#include <cmath>
+#include <sciuter/scripts.hpp>
+#include <sciuter/systems.hpp>
+
+ScriptFramePool ScriptFramePool::s_instance;
+
+void* ScriptFramePool::_allocate(const size_t size)
+{
+    if(size > BLOCK_SIZE)
+    {
+        return ::operator new(size);
+    }
+
+    if(nullptr == m_free)
+    {
+        // operator new[] alignment holds for every block, BLOCK_SIZE
+        // being a multiple of it
+        m_chunks.emplace_back(new char[BLOCK_SIZE * BLOCKS_PER_CHUNK]);
+        char* chunk = m_chunks.back().get();
+        for(size_t i = BLOCKS_PER_CHUNK; i > 0; --i)
+        {
+            block* free = reinterpret_cast<block*>(chunk + (i - 1) * BLOCK_SIZE);
+            free->next = m_free;
+            m_free = free;
+        }
+    }
+
+    block* frame = m_free;
+    m_free = frame->next;
+    m_used += 1;
+    return frame;
+}
+
+void ScriptFramePool::_deallocate(void* frame, const size_t size)
+{
+    if(size > BLOCK_SIZE)
+    {
+        ::operator delete(frame);
+        return;
+    }
+
+    block* free = static_cast<block*>(frame);
+    free->next = m_free;
+    m_free = free;
+    m_used -= 1;
+}
+
+ScriptScheduler::~ScriptScheduler()
+{
+    while(!m_events.empty())
+    {
+        m_events.top().coroutine.destroy();
+        m_events.pop();
+    }
+}
+
+void ScriptScheduler::start(const entt::entity entity, script&& coroutine)
+{
+    script::handle handle = coroutine.release();
+    handle.promise().entity = entity;
+    handle.promise().scheduler = this;
+    resume_at(m_time, handle);
+}
+
+void ScriptScheduler::resume_at(const double time, script::handle coroutine)
+{
+    m_events.push({time, m_sequence++, coroutine});
+}
+
+void ScriptScheduler::update(const float dt)
+{
+    m_time += dt;
+
+    // events queued while resuming wait for the next update, even when
+    // already due: a script waiting 0 seconds in a loop can't stall it
+    const Uint64 first_new = m_sequence;
+
+    while(!m_events.empty() &&
+          m_events.top().time <= m_time &&
+          m_events.top().sequence < first_new)
+    {
+        script::handle coroutine = m_events.top().coroutine;
+        m_events.pop();
+
+        if(!m_registry.valid(coroutine.promise().entity))
+        {
+            coroutine.destroy();
+            continue;
+        }
+
+        coroutine.resume();
+        if(coroutine.done())
+        {
+            coroutine.destroy();
+        }
+    }
+}
+
+void ScriptScheduler::fire(script::promise_type& promise,
+                           const components::bullet_pattern_id pattern,
+                           const bool in_line)
+{
+    const entt::entity entity = promise.entity;
+
+    // out of view the bullets would be released right away
+    if(m_registry.has<components::culled>(entity))
+    {
+        return;
+    }
+
+    const auto &dest = m_registry.get<components::destination_rect>(entity);
+    const components::position origin = {
+        (float)(dest.x + dest.w / 2),
+        (float)(dest.y + dest.h)
+    };
+    components::velocity aim = {0.f, 1.f, 0.f};
+    auto target = m_registry.try_get<components::target>(entity);
+
+    if(nullptr != target && m_registry.valid(target->entity))
+    {
+        auto &target_pos = m_registry.get<components::destination_rect>(target->entity);
+
+        if(in_line && (target_pos.x >= dest.x + dest.w ||
+                       target_pos.x + target_pos.w <= dest.x))
+        {
+            return;
+        }
+        aim = {
+            target_pos.x + target_pos.w / 2 - origin.x,
+            target_pos.y + target_pos.h / 2 - origin.y,
+            0.f
+        };
+        aim.normalize();
+    }
+    else if(in_line)
+    {
+        return;
+    }
+
+    m_patterns.fire(pattern, promise.shot++, origin, aim,
+                    COLLISION_MASK_PLAYER, m_bullets, m_registry);
+}
+
+namespace scripts
+{
+    bool move_to::await_suspend(script::handle coroutine)
+    {
+        promise = &coroutine.promise();
+        ScriptScheduler* scheduler = promise->scheduler;
+        entt::registry& registry = scheduler->get_registry();
+        auto &position = registry.get<components::position>(promise->entity);
+        auto &velocity = registry.get<components::velocity>(promise->entity);
+
+        const float dx = x - position.x;
+        const float dy = y - position.y;
+        const float distance = std::sqrt(dx * dx + dy * dy);
+
+        if(distance == 0.f || speed <= 0.f)
+        {
+            return false;
+        }
+
+        velocity = {dx / distance, dy / distance, speed};
+        scheduler->resume_at(scheduler->get_time() + distance / speed, coroutine);
+        return true;
+    }
+
+    void move_to::await_resume()
+    {
+        if(nullptr == promise)
+        {
+            return;
+        }
+
+        // arrival is noticed up to a tick late, snap to the destination
+        entt::registry& registry = promise->scheduler->get_registry();
+        auto &position = registry.get<components::position>(promise->entity);
+        auto &velocity = registry.get<components::velocity>(promise->entity);
+        position.x = x;
+        position.y = y;
+        velocity.dx = 0.f;
+        velocity.dy = 0.f;
+    }
+}
@@ -37,10 +37,34 @@ SDL_Window* sdl_init(const int screen_width, const int screen_height)
     return window;
 }
 
+bool sdl_init_headless()
+{
+    // the dummy video driver needs no display, rendering goes through
+    // the software renderer into a plain surface
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+    if( SDL_Init( SDL_INIT_VIDEO ) < 0 )
+    {
+	SDL_Log("SDL could not initialize! SDL_Error: %s", SDL_GetError());
+        return false;
+    }
+
+    if(! IMG_Init(IMG_INIT_PNG))
+    {
+	SDL_Log("SDL_Image could not initialize! SDL_Error: %s", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
 void sdl_quit(SDL_Window* window)
 {
     //Destroy window
-    SDL_DestroyWindow( window );
+    if( nullptr != window )
+    {
+        SDL_DestroyWindow( window );
+    }
 
     IMG_Quit();
     SDL_Quit();
@@ -79,27 +103,40 @@ SDL_Surface* load_surface(const std::string& path, const SDL_PixelFormat* format
     return surface;
 }
 
-SDL_Texture* load_texture( const std::string path, SDL_Renderer* renderer )
+SDL_Surface* load_surface(SDL_RWops* stream, const std::string& name, const SDL_PixelFormat* format)
 {
-    //The final texture
-    SDL_Texture* texture = nullptr;
-
-    //Load image at specified path
-    SDL_Surface* surface = IMG_Load( path.c_str() );
-    if( nullptr == surface )
+    //Decode the image, the stream is closed in any case
+    SDL_Surface* surface = IMG_Load_RW( stream, 1 );
+    if( nullptr == surface)
     {
         SDL_Log("Unable to load image %s! SDL_image Error: %s",
-		path.c_str(),
-		IMG_GetError());
+		name.c_str(),
+	        IMG_GetError());
     }
-    else
+
+    if( nullptr != format )
+    {
+        SDL_Surface* optimized = optimize_surface(surface, format);
+        SDL_FreeSurface(surface);
+        return optimized;
+    }
+
+    return surface;
+}
+
+SDL_Texture* create_texture( SDL_Surface* surface, const std::string& name, SDL_Renderer* renderer )
+{
+    //The final texture
+    SDL_Texture* texture = nullptr;
+
+    if( nullptr != surface )
     {
         //Create texture from surface pixels
         texture = SDL_CreateTextureFromSurface( renderer, surface );
         if( nullptr == texture )
         {
             SDL_Log("Unable to create texture from %s! SDL Error: %s",
-		    path.c_str(),
+		    name.c_str(),
 		    SDL_GetError());
         }
 
@@ -109,3 +146,18 @@ SDL_Texture* load_texture( const std::string path, SDL_Renderer* renderer )
 
     return texture;
 }
+
+SDL_Texture* load_texture( const std::string path, SDL_Renderer* renderer )
+{
+    return create_texture( load_surface( path ), path, renderer );
+}
+
+SDL_Rect texture_rect( SDL_Texture* texture )
+{
+    SDL_Rect rect = {0, 0, 0, 0};
+    if( nullptr != texture )
+    {
+        SDL_QueryTexture( texture, nullptr, nullptr, &rect.w, &rect.h );
+    }
+    return rect;
+}
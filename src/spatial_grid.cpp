@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <sciuter/spatial_grid.hpp>
+
+SpatialGrid::SpatialGrid(const SDL_Rect& bounds, const int cell_size)
+    : m_bounds(bounds), m_cell_size(cell_size)
+{
+    m_columns = std::max(1, (bounds.w + cell_size - 1) / cell_size);
+    m_rows = std::max(1, (bounds.h + cell_size - 1) / cell_size);
+    m_cell_start.resize(m_columns * m_rows + 1, 0);
+    m_cell_next.resize(m_columns * m_rows, 0);
+}
+
+int SpatialGrid::cell_x(const int x) const
+{
+    if(x < m_bounds.x) return 0;
+    return std::min((x - m_bounds.x) / m_cell_size, m_columns - 1);
+}
+
+int SpatialGrid::cell_y(const int y) const
+{
+    if(y < m_bounds.y) return 0;
+    return std::min((y - m_bounds.y) / m_cell_size, m_rows - 1);
+}
+
+void SpatialGrid::clear()
+{
+    m_items.clear();
+    m_cell_items.clear();
+    std::fill(m_cell_start.begin(), m_cell_start.end(), 0);
+}
+
+void SpatialGrid::insert(const entt::entity entity, const SDL_Rect& rect)
+{
+    m_items.push_back({
+        entity, rect,
+        cell_x(rect.x), cell_y(rect.y),
+        cell_x(rect.x + rect.w - 1), cell_y(rect.y + rect.h - 1)});
+}
+
+void SpatialGrid::build()
+{
+    // counting sort of the items by cell: first count how many items
+    // land in each cell, then turn counts into start offsets and
+    // finally scatter item indices into their cell ranges
+    std::fill(m_cell_start.begin(), m_cell_start.end(), 0);
+
+    for(const auto& item : m_items)
+    {
+        for(int cy = item.y0; cy <= item.y1; ++cy)
+        {
+            for(int cx = item.x0; cx <= item.x1; ++cx)
+            {
+                m_cell_start[cy * m_columns + cx + 1] += 1;
+            }
+        }
+    }
+
+    for(size_t cell = 1; cell < m_cell_start.size(); ++cell)
+    {
+        m_cell_start[cell] += m_cell_start[cell - 1];
+    }
+
+    m_cell_items.resize(m_cell_start.back());
+    std::copy(m_cell_start.begin(), m_cell_start.end() - 1, m_cell_next.begin());
+
+    for(unsigned int index = 0; index < m_items.size(); ++index)
+    {
+        const auto& item = m_items[index];
+        for(int cy = item.y0; cy <= item.y1; ++cy)
+        {
+            for(int cx = item.x0; cx <= item.x1; ++cx)
+            {
+                m_cell_items[m_cell_next[cy * m_columns + cx]++] = index;
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#include <sciuter/sprite_batch.hpp>
+
+void SpriteBatch::begin(SDL_Renderer* renderer)
+{
+    m_renderer = renderer;
+    m_texture = nullptr;
+    m_draw_calls = 0;
+    m_sprites = 0;
+}
+
+void SpriteBatch::set_texture(SDL_Texture* texture)
+{
+    flush();
+    m_texture = texture;
+
+    // queried once per run of sprites, needed to normalize texture coords
+    int width, height;
+    SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+    m_texture_width = width;
+    m_texture_height = height;
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+
+void SpriteBatch::draw(SDL_Texture* texture,
+                       const SDL_Rect& source,
+                       const SDL_Rect& destination)
+{
+    if(texture != m_texture)
+    {
+        set_texture(texture);
+    }
+
+    const float u0 = source.x / m_texture_width;
+    const float v0 = source.y / m_texture_height;
+    const float u1 = (source.x + source.w) / m_texture_width;
+    const float v1 = (source.y + source.h) / m_texture_height;
+    const float x0 = destination.x;
+    const float y0 = destination.y;
+    const float x1 = destination.x + destination.w;
+    const float y1 = destination.y + destination.h;
+    const SDL_Color white = {0xFF, 0xFF, 0xFF, 0xFF};
+
+    m_vertices.push_back({{x0, y0}, white, {u0, v0}});
+    m_vertices.push_back({{x1, y0}, white, {u1, v0}});
+    m_vertices.push_back({{x0, y1}, white, {u0, v1}});
+    m_vertices.push_back({{x1, y1}, white, {u1, v1}});
+    m_sprites += 1;
+}
+
+void SpriteBatch::flush()
+{
+    if(m_vertices.empty())
+    {
+        return;
+    }
+
+    const int quads = m_vertices.size() / 4;
+
+    // two triangles per quad: 0 1 2 and 2 1 3
+    for(int quad = m_indices.size() / 6; quad < quads; ++quad)
+    {
+        const int first = quad * 4;
+        m_indices.insert(m_indices.end(), {
+            first, first + 1, first + 2,
+            first + 2, first + 1, first + 3});
+    }
+
+    if(SDL_RenderGeometry(m_renderer, m_texture,
+                          m_vertices.data(), m_vertices.size(),
+                          m_indices.data(), quads * 6) != 0)
+    {
+        SDL_Log("SDL_RenderGeometry failed: %s", SDL_GetError());
+    }
+
+    m_vertices.clear();
+    m_draw_calls += 1;
+}
+
+#else
+
+void SpriteBatch::draw(SDL_Texture* texture,
+                       const SDL_Rect& source,
+                       const SDL_Rect& destination)
+{
+    SDL_RenderCopy(m_renderer, texture, &source, &destination);
+    m_draw_calls += 1;
+    m_sprites += 1;
+}
+
+void SpriteBatch::flush()
+{
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <sciuter/profiler.hpp>
+#include <sciuter/system_scheduler.hpp>
+
+static bool intersect(const std::vector<SystemScheduler::resource_id>& a,
+                      const std::vector<SystemScheduler::resource_id>& b)
+{
+    for(const auto id : a)
+    {
+        if(std::find(b.begin(), b.end(), id) != b.end())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const bool SystemScheduler::system::conflicts(const system& other) const
+{
+    return m_exclusive || other.m_exclusive ||
+        intersect(m_writes, other.m_writes) ||
+        intersect(m_writes, other.m_reads) ||
+        intersect(m_reads, other.m_writes);
+}
+
+SystemScheduler::system& SystemScheduler::add(const char* name,
+                                              system_function function)
+{
+    m_systems.push_back(std::make_unique<system>(name, std::move(function)));
+    m_built = false;
+    return *m_systems.back();
+}
+
+void SystemScheduler::build()
+{
+    for(auto& node : m_systems)
+    {
+        node->m_successors.clear();
+        node->m_dependencies = 0;
+    }
+
+    // a system waits for the earlier systems it conflicts with; edges
+    // already implied through another dependency are kept, the graph
+    // is a few dozen nodes at most
+    for(size_t later = 0; later < m_systems.size(); ++later)
+    {
+        for(size_t earlier = 0; earlier < later; ++earlier)
+        {
+            if(m_systems[later]->conflicts(*m_systems[earlier]))
+            {
+                m_systems[earlier]->m_successors.push_back(later);
+                m_systems[later]->m_dependencies += 1;
+            }
+        }
+    }
+    m_built = true;
+}
+
+void SystemScheduler::execute(const size_t index, const float dt,
+                              WorkStealingPool& pool)
+{
+    system& node = *m_systems[index];
+    {
+        SCIUTER_PROFILE_ZONE(node.m_name);
+        const Uint64 start = SDL_GetPerformanceCounter();
+        node.m_function(dt);
+        node.m_counter_ticks = SDL_GetPerformanceCounter() - start;
+    }
+
+    for(const size_t successor : node.m_successors)
+    {
+        if(m_systems[successor]->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            pool.push([this, successor, dt, &pool] { execute(successor, dt, pool); });
+        }
+    }
+    m_remaining.fetch_sub(1, std::memory_order_release);
+    m_remaining.notify_all();
+}
+
+void SystemScheduler::run(const float dt, WorkStealingPool* pool)
+{
+    if(nullptr == pool || pool->size() < 2)
+    {
+        for(auto& node : m_systems)
+        {
+            SCIUTER_PROFILE_ZONE(node->m_name);
+            const Uint64 start = SDL_GetPerformanceCounter();
+            node->m_function(dt);
+            node->m_counter_ticks = SDL_GetPerformanceCounter() - start;
+        }
+        return;
+    }
+
+    if(!m_built)
+    {
+        build();
+    }
+
+    for(auto& node : m_systems)
+    {
+        node->m_pending.store(node->m_dependencies, std::memory_order_relaxed);
+    }
+    m_remaining.store(m_systems.size(), std::memory_order_relaxed);
+
+    for(size_t index = 0; index < m_systems.size(); ++index)
+    {
+        if(m_systems[index]->m_dependencies == 0)
+        {
+            pool->push([this, index, dt, pool] { execute(index, dt, *pool); });
+        }
+    }
+    pool->wait(m_remaining);
+}
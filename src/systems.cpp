@@ -1,40 +1,102 @@
 #include <iostream>
 #include <sciuter/systems.hpp>
 
-void update_timers(const float dt, entt::registry& registry)
+// fewest entities handed to a thread by the systems split in ranges:
+// handing a range over costs more than updating a few hundred entities,
+// so levels of the current size run on a single thread anyway
+const size_t RANGE_GRAIN = 4096;
+
+/**
+ * Same as view.contains, which moves an iterator past the entities out
+ * of the view and so costs up to the whole view per call
+ */
+template<typename... Exclude, typename... Component>
+static bool in_view(const entt::registry& registry,
+                    const entt::basic_view<entt::entity, entt::exclude_t<Exclude...>, Component...>&,
+                    const entt::entity entity)
 {
-    auto view = registry.view<
-        components::timer>();
+    return registry.has<Component...>(entity) && !(registry.has<Exclude>(entity) || ...);
+}
 
-    for(auto entity: view) {
-        auto &timer = view.get<components::timer>(entity);
-	timer.update(dt);
+/**
+ * Call func on every entity of view; with a pool the entities of the
+ * Candidate component are split in ranges run concurrently, so func
+ * must touch only the components of its entity
+ */
+template<typename Candidate, typename View, typename Func>
+static void each_in_ranges(WorkStealingPool* pool,
+                           entt::registry& registry,
+                           View& view,
+                           Func func)
+{
+    if(nullptr == pool)
+    {
+        for(auto entity: view) {
+            func(entity);
+        }
+        return;
     }
+
+    const entt::entity* entities = registry.data<Candidate>();
+    pool->parallel_for(registry.size<Candidate>(), RANGE_GRAIN,
+                       [&](const size_t begin, const size_t end) {
+        for(size_t i = begin; i < end; ++i)
+        {
+            if(in_view(registry, view, entities[i]))
+            {
+                func(entities[i]);
+            }
+        }
+    });
 }
 
-void handle_gamepad(
-    const SDL_Rect& boundaries,
-    entt::registry& registry)
+void store_previous_positions(entt::registry& registry, WorkStealingPool* pool)
 {
     auto view = registry.view<
         components::position,
+        components::previous_position>(entt::exclude<components::inactive>);
+
+    each_in_ranges<components::previous_position>(pool, registry, view,
+                                                  [&view](const entt::entity entity) {
+        auto &position = view.get<components::position>(entity);
+        auto &previous = view.get<components::previous_position>(entity);
+
+        previous.x = position.x;
+        previous.y = position.y;
+    });
+}
+
+void handle_gamepad(InputRecording& input,
+                    const std::vector<Uint8>& keyboard,
+                    entt::registry& registry)
+{
+    auto view = registry.view<
         components::velocity,
-        components::timer,
         components::gamepad>();
 
     for(auto entity: view) {
-        auto &position = view.get<components::position>(entity);
         auto &velocity = view.get<components::velocity>(entity);
-        auto &timer = view.get<components::timer>(entity);
         auto &gamepad = view.get<components::gamepad>(entity);
 
-        gamepad.update();
+        // a replay replaces the keyboard with the recorded statuses
+        if(input.get_mode() == InputRecording::mode::replay)
+        {
+            gamepad.set_status(input.next());
+        }
+        else
+        {
+            gamepad.set_status(gamepad.read_keyboard(keyboard.data()));
+            if(input.get_mode() == InputRecording::mode::record)
+            {
+                input.push(gamepad.current_status);
+            }
+        }
 
-        if(gamepad.down("move_left"))
+        if(gamepad.down(components::action::move_left))
         {
             velocity.dx = -1;
         }
-        else if(gamepad.down("move_right"))
+        else if(gamepad.down(components::action::move_right))
         {
             velocity.dx = 1;
         }
@@ -43,11 +105,11 @@ void handle_gamepad(
             velocity.dx = 0;
         }
 
-        if(gamepad.down("move_up"))
+        if(gamepad.down(components::action::move_up))
         {
             velocity.dy = -1;
         }
-        else if(gamepad.down("move_down"))
+        else if(gamepad.down(components::action::move_down))
         {
             velocity.dy = 1;
         }
@@ -57,13 +119,26 @@ void handle_gamepad(
         }
 
         velocity.normalize();
+    }
+}
 
-        if(gamepad.down("fire") && timer.timed_out())
+void fire_player_bullets(BulletPool& bullets, entt::registry& registry)
+{
+    auto view = registry.view<
+        components::position,
+        components::timer,
+        components::gamepad>();
+
+    for(auto entity: view) {
+        auto &timer = view.get<components::timer>(entity);
+        auto &gamepad = view.get<components::gamepad>(entity);
+
+        if(gamepad.down(components::action::fire) && timer.timed_out())
         {
             spawn_bullet(
-		position, {0.f, -1.f, 150.f},
+		view.get<components::position>(entity), {0.f, -1.f, 150.f},
 		COLLISION_MASK_ENEMIES,
-		boundaries, registry);
+		bullets, registry);
 	}
     }
 }
@@ -80,244 +155,268 @@ SDL_Rect center_position(const int x, const int y, const SDL_Rect& frame_rect)
 
 void update_animations(const float dt, entt::registry &registry)
 {
+    // culled entities resume their animation when they come in view
     auto view = registry.view<
         components::animation,
-        components::source_rect>();
+        components::source_rect>(entt::exclude<components::culled>);
 
     for(auto entity: view) {
         auto &animation = view.get<components::animation>(entity);
         auto &frame_rect = view.get<components::source_rect>(entity);
-        animation.update(dt);
-        frame_rect.rect = animation.get_current_frame();
+        const animation_clip& clip = Resources::get_animation_clip(animation.clip);
+
+        animation.update(dt, clip);
+        frame_rect.rect = animation.get_current_frame(clip);
     }
 }
 
-void update_linear_velocity(const float dt, entt::registry& registry)
+void update_linear_velocity(const float dt,
+                            entt::registry& registry,
+                            WorkStealingPool* pool)
 {
     auto view = registry.view<
         components::position,
-        components::velocity>();
+        components::velocity>(entt::exclude<components::bullet_slot>);
 
-    for(auto entity: view) {
+    each_in_ranges<components::velocity>(pool, registry, view,
+                                         [&view, dt](const entt::entity entity) {
         auto &position = view.get<components::position>(entity);
         auto &velocity = view.get<components::velocity>(entity);
 
         position.x += velocity.dx * velocity.speed * dt;
         position.y += velocity.dy * velocity.speed * dt;
-    }
+    });
 }
 
-void update_destination_rect(entt::registry& registry)
+void update_destination_rect(entt::registry& registry, WorkStealingPool* pool)
 {
     auto view = registry.view<
         components::position,
         components::source_rect,
-        components::destination_rect>();
+        components::destination_rect>(entt::exclude<components::bullet_slot,
+                                                     components::culled>);
 
-    for(auto entity: view) {
+    each_in_ranges<components::destination_rect>(pool, registry, view,
+                                                 [&view](const entt::entity entity) {
         auto &position = view.get<components::position>(entity);
         auto &frame_rect = view.get<components::source_rect>(entity);
         auto &dest = view.get<components::destination_rect>(entity);
 
         dest = center_position(position.x, position.y, frame_rect.rect);
-    }
+    });
 }
 
-void apply_camera_transformation(const entt::entity& camera,
-				 entt::registry& registry)
+void interpolate_destination_rect(const float alpha, entt::registry& registry)
 {
     auto view = registry.view<
-        components::world_position,
-        components::destination_rect>();
-    auto &camera_pos = registry.get<components::position>(camera);
-
-    if(camera_pos.y < 0) camera_pos.y = 0;
+        components::position,
+        components::previous_position,
+        components::source_rect,
+        components::destination_rect>(entt::exclude<components::inactive,
+                                                     components::culled>);
 
     for(auto entity: view) {
+        auto &position = view.get<components::position>(entity);
+        auto &previous = view.get<components::previous_position>(entity);
+        auto &frame_rect = view.get<components::source_rect>(entity);
         auto &dest = view.get<components::destination_rect>(entity);
 
-	dest.x -= camera_pos.x;
-	dest.y -= camera_pos.y;
+        dest = center_position(
+            previous.x + (position.x - previous.x) * alpha,
+            previous.y + (position.y - previous.y) * alpha,
+            frame_rect.rect);
     }
 }
 
-void update_shot_to_target_behaviour(
-    const SDL_Rect& boundaries,
-    entt::registry& registry)
+/**
+ * Tag the world entities whose sprite is farther than margin from the
+ * camera view as culled, and untag the ones back in view; tested in world
+ * coordinates since culled entities don't get a destination rect
+ */
+void cull_offscreen(const entt::entity& camera,
+		    const SDL_Rect& viewport,
+		    const int margin,
+		    entt::registry& registry)
 {
     auto view = registry.view<
-        components::timer,
-        components::target,
-        components::destination_rect>();
+        components::world_position,
+        components::position,
+        components::source_rect>();
+    const auto &camera_pos = registry.get<components::position>(camera);
+
+    const SDL_Rect visible = {
+	viewport.x + static_cast<int>(camera_pos.x) - margin,
+	viewport.y + static_cast<int>(camera_pos.y) - margin,
+	viewport.w + margin * 2,
+	viewport.h + margin * 2,
+    };
+
+    // the tag changes only when crossing the edge, to keep the render
+    // group stable; changing it reorders source_rect, so the changes are
+    // applied once the view is done
+    std::vector<entt::entity> entered;
+    std::vector<entt::entity> left;
 
     for(auto entity: view) {
-        auto &timer = view.get<components::timer>(entity);
-        auto &dest = view.get<components::destination_rect>(entity);
-        auto &target = view.get<components::target>(entity);
-	auto &target_pos = registry.get<components::destination_rect>(target.entity);
+        auto &position = view.get<components::position>(entity);
+        auto &frame_rect = view.get<components::source_rect>(entity);
+	const SDL_Rect rect = center_position(position.x, position.y, frame_rect.rect);
+	const bool in_view = SDL_HasIntersection(&rect, &visible);
+	const bool culled = registry.has<components::culled>(entity);
 
-	if(timer.timed_out() &&
-	   target_pos.x < dest.x + dest.w &&
-	   target_pos.x + target_pos.w > dest.x)
+	if(in_view && culled)
 	{
-	    const components::position& position = {
-		(float)(dest.x + dest.w / 2),
-		(float)(dest.y + dest.h)
-	    };
-	    components::velocity velocities[] = {
-		{0.f, 1.f, 90.f},
-		{0.5f, 1.f, 90.f},
-		{1.f, 1.f, 90.f},
-		{2.f, 1.f, 80.f},
-		{3.f, 1.f, 70.f},
-		{-3.f, 1.f, 70.f},
-		{-2.f, 1.f, 80.f},
-		{-1.f, 1.f, 90.f},
-		{-0.5f, 1.f, 90.f},
-	    };
-	    for(auto& velocity : velocities) {
-		spawn_bullet(position, velocity.normalize(),
-			     COLLISION_MASK_PLAYER,
-			     boundaries, registry);
-	    }
+	    entered.push_back(entity);
 	}
+	else if(!in_view && !culled)
+	{
+	    left.push_back(entity);
+	}
+    }
+
+    for(auto entity: entered) {
+	registry.remove<components::culled>(entity);
+    }
+    for(auto entity: left) {
+	registry.assign<components::culled>(entity);
     }
 }
 
-void check_boundaries(entt::registry& registry)
+void apply_camera_transformation(const entt::entity& camera,
+				 entt::registry& registry,
+				 const float alpha)
 {
     auto view = registry.view<
-        components::destination_rect,
-        components::screen_boundaries>();
+        components::world_position,
+        components::destination_rect>(entt::exclude<components::culled>);
+    auto &camera_pos = registry.get<components::position>(camera);
+
+    if(camera_pos.y < 0) camera_pos.y = 0;
+
+    float camera_x = camera_pos.x;
+    float camera_y = camera_pos.y;
+
+    if(auto previous = registry.try_get<components::previous_position>(camera))
+    {
+	camera_x = previous->x + (camera_pos.x - previous->x) * alpha;
+	camera_y = previous->y + (camera_pos.y - previous->y) * alpha;
+    }
 
     for(auto entity: view) {
-        auto &dest_rect = view.get<components::destination_rect>(entity);
-        auto &boundaries = view.get<components::screen_boundaries>(entity);
+        auto &dest = view.get<components::destination_rect>(entity);
 
-        if(!SDL_HasIntersection(&dest_rect, &boundaries.rect))
-        {
-            registry.destroy(entity);
-        }
+	dest.x -= camera_x;
+	dest.y -= camera_y;
     }
 }
 
-void resolve_collisions(entt::registry& registry)
+void resolve_collisions(SpatialGrid& grid,
+                        CommandBuffer& commands,
+                        entt::registry& registry)
 {
     auto view_bullets = registry.view<
         components::destination_rect,
         components::collision_mask,
-        components::damage>();
+        components::damage>(entt::exclude<components::inactive>);
+    // bullets live on screen and can't reach culled targets
     auto view_targets = registry.view<
         components::destination_rect,
         components::collision_mask,
-        components::energy>();
+        components::energy>(entt::exclude<components::culled>);
+
+    // broadphase: bucket targets by screen cell so that every bullet
+    // is tested only against the targets close to it
+    grid.clear();
+    for(auto target: view_targets) {
+        grid.insert(target, view_targets.get<components::destination_rect>(target));
+    }
+    grid.build();
 
     for(auto bullet: view_bullets) {
         auto &bullet_mask = view_bullets.get<components::collision_mask>(bullet);
         auto &bullet_rect = view_bullets.get<components::destination_rect>(bullet);
         auto &damage = view_bullets.get<components::damage>(bullet);
 
-        for(auto target: view_targets) {
-	    auto &target_mask = view_targets.get<components::collision_mask>(target);
-	    auto &target_rect = view_targets.get<components::destination_rect>(target);
+        grid.query(bullet_rect, [&](const entt::entity target,
+                                    const SDL_Rect& target_rect) {
+            auto &target_mask = view_targets.get<components::collision_mask>(target);
             auto &energy = view_targets.get<components::energy>(target);
 
-	    if(!registry.valid(bullet) || !registry.valid(target)) continue;
-
-            if((bullet_mask.value & target_mask.value) != 0 &&
-	       SDL_HasIntersection(&bullet_rect, &target_rect))
+            // targets already killed this frame are waiting to be
+            // destroyed and must not absorb other bullets
+            if(energy.value > 0 &&
+               (bullet_mask.value & target_mask.value) != 0 &&
+               SDL_HasIntersection(&bullet_rect, &target_rect))
             {
-                registry.destroy(bullet);
+                BulletPool::release(bullet, commands);
                 energy.value -= damage.value;
 
                 if(energy.value <= 0)
                 {
-                    registry.destroy(target);
+                    commands.destroy(target);
                 }
+                // the bullet is gone, stop looking for other targets
+                return true;
             }
-        }
+            return false;
+        });
     }
 }
 
 void render_sprites(SDL_Renderer* renderer,
-		    const int scale,
+		    SpriteBatch& batch,
+		    RenderOrder& render_order,
 		    entt::registry& registry)
 {
-    auto group = registry.group<
-	components::draw_order,
-        components::image,
-        components::source_rect,
-        components::destination_rect>();
+    auto group = render_group(registry);
 
-    group.sort<components::draw_order>([](const components::draw_order a,
-					  const components::draw_order b) {
-	return a < b;
-    });
+    // sprites sharing a layer are grouped by texture, so that the batch
+    // can merge them in a single draw call
+    render_order.sort();
+
+    // scaling by the entity transformation is already applied to the
+    // destination rect by update_transformations, the upscale to the
+    // window is left to the caller
+    batch.begin(renderer);
 
     for(auto entity: group) {
 	auto &image = group.get<components::image>(entity);
 	auto &frame = group.get<components::source_rect>(entity);
 	auto &dest = group.get<components::destination_rect>(entity);
-	const SDL_Rect scaled {
-	    dest.x * scale, dest.y * scale,
-	    dest.w * scale, dest.h * scale,
-	};
-
-	SDL_RenderCopy(
-	    renderer, image.texture,
-	    &frame.rect, &scaled);
+
+	batch.draw(image.texture, frame.rect, dest);
     }
+
+    batch.flush();
 }
 
 entt::entity spawn_bullet(
-    const components::position& position,
-    const components::velocity& velocity,
+    const components::position position,
+    const components::velocity velocity,
     const unsigned int collision_mask,
-    const SDL_Rect& boundaries,
+    BulletPool& bullets,
     entt::registry& registry)
 {
-    auto bullet = registry.create();
-    SDL_Texture* texture;
-    if(collision_mask & COLLISION_MASK_ENEMIES) {
-	texture = Resources::get_texture("bullet"_hs)->value;
-    } else {
-	texture = Resources::get_texture("bullet-enemy"_hs)->value;
-    }
-    registry.assign<components::position>(bullet, position);
-    registry.assign<components::source_rect>(
-            bullet,
-            components::source_rect::from_texture(texture));
-    registry.assign<components::destination_rect>(bullet);
-    registry.assign<components::velocity>(bullet, velocity);
-    registry.assign<components::screen_boundaries>(bullet, boundaries);
-    registry.assign<components::damage>(bullet, 10);
-    registry.assign<components::collision_mask>(bullet, collision_mask);
-    registry.assign<components::image>(bullet, texture);
-    registry.assign<components::draw_order>(bullet, 1);
-    return bullet;
+    return bullets.acquire(position, velocity, collision_mask, registry);
 }
 
 void update_behaviors(const float dt, entt::registry &registry)
 {
-    auto view = registry.view<
-        components::entity_behavior>();
-
-    for (auto entity : view) {
-      auto &behavior = view.get<components::entity_behavior>(entity);
+    // one loop per behavior type, over its own pool
+    auto bosses = boss_behavior_group(registry);
 
-      behavior->update(dt, entity, registry);
-
-      if (behavior->has_finished()) {
-	  // registry.destroy(entity);
-      }
-    }
+    bosses.each([](const components::boss_behavior& behavior,
+                   const components::position& position,
+                   components::velocity& velocity) {
+        behavior.update(position, velocity);
+    });
 }
 
 void update_transformations(entt::registry &registry)
 {
     auto view = registry.view<
 	components::destination_rect,
-        components::transformation>();
+        components::transformation>(entt::exclude<components::culled>);
 
     for (auto entity : view) {
       auto &dest = view.get<components::destination_rect>(entity);
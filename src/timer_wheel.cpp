@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cmath>
+#include <sciuter/timer_wheel.hpp>
+
+TimerWheel::TimerWheel(entt::registry& registry)
+    : m_registry(registry)
+{
+    std::fill(std::begin(m_slots), std::end(m_slots), NIL);
+    registry.on_construct<components::timer>().connect<&TimerWheel::on_construct>(*this);
+    registry.on_destroy<components::timer>().connect<&TimerWheel::on_destroy>(*this);
+}
+
+TimerWheel::~TimerWheel()
+{
+    m_registry.on_construct<components::timer>().disconnect(*this);
+    m_registry.on_destroy<components::timer>().disconnect(*this);
+}
+
+void TimerWheel::on_construct(const entt::entity entity,
+                              entt::registry&,
+                              components::timer& timer)
+{
+    timer.handle = NIL;
+    m_pending.push_back(entity);
+}
+
+void TimerWheel::on_destroy(const entt::entity entity, entt::registry&)
+{
+    const Uint32 handle = m_registry.get<components::timer>(entity).handle;
+
+    if(handle == NIL)
+    {
+        m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), entity),
+                        m_pending.end());
+    }
+    else
+    {
+        remove(handle);
+    }
+}
+
+Uint32 TimerWheel::add(const entt::entity entity, const Uint64 delay, const Uint32 period)
+{
+    Uint32 handle = m_free;
+    if(handle == NIL)
+    {
+        handle = m_nodes.size();
+        m_nodes.emplace_back();
+    }
+    else
+    {
+        m_free = m_nodes[handle].next;
+    }
+
+    node& timer = m_nodes[handle];
+    timer.entity = entity;
+    timer.expiry = m_now + std::clamp<Uint64>(delay, 1, MAX_TICKS);
+    timer.period = period;
+    insert(handle);
+    m_count += 1;
+    return handle;
+}
+
+void TimerWheel::remove(const Uint32 handle)
+{
+    unlink(handle);
+    m_nodes[handle].next = m_free;
+    m_free = handle;
+    m_count -= 1;
+}
+
+void TimerWheel::insert(const Uint32 handle)
+{
+    node& timer = m_nodes[handle];
+    const Uint64 delay = timer.expiry - m_now;
+
+    // the lowest level whose span covers the delay, slots are indexed
+    // by the expiry bits of that level
+    Uint32 level = 0;
+    while(level + 1 < LEVELS && delay >= (Uint64(1) << (SLOT_BITS * (level + 1))))
+    {
+        ++level;
+    }
+    timer.slot = level * SLOTS + ((timer.expiry >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    timer.prev = NIL;
+    timer.next = m_slots[timer.slot];
+    if(timer.next != NIL)
+    {
+        m_nodes[timer.next].prev = handle;
+    }
+    m_slots[timer.slot] = handle;
+}
+
+void TimerWheel::unlink(const Uint32 handle)
+{
+    node& timer = m_nodes[handle];
+
+    if(timer.prev != NIL)
+    {
+        m_nodes[timer.prev].next = timer.next;
+    }
+    else
+    {
+        m_slots[timer.slot] = timer.next;
+    }
+    if(timer.next != NIL)
+    {
+        m_nodes[timer.next].prev = timer.prev;
+    }
+}
+
+void TimerWheel::cascade(const Uint32 level)
+{
+    // the timers of the slot now starting move to the lower levels
+    const Uint32 slot = level * SLOTS + ((m_now >> (SLOT_BITS * level)) & (SLOTS - 1));
+    Uint32 handle = m_slots[slot];
+    m_slots[slot] = NIL;
+
+    while(handle != NIL)
+    {
+        const Uint32 next = m_nodes[handle].next;
+        insert(handle);
+        handle = next;
+    }
+}
+
+void TimerWheel::advance()
+{
+    m_now += 1;
+
+    // a level moves to its next slot when all the levels below wrapped
+    // around, the upper ones cascade first
+    Uint32 turned = 1;
+    while(turned < LEVELS &&
+          ((m_now >> (SLOT_BITS * (turned - 1))) & (SLOTS - 1)) == 0)
+    {
+        ++turned;
+    }
+    for(Uint32 level = turned - 1; level > 0; --level)
+    {
+        cascade(level);
+    }
+
+    const Uint32 slot = m_now & (SLOTS - 1);
+    Uint32 handle = m_slots[slot];
+    m_slots[slot] = NIL;
+
+    while(handle != NIL)
+    {
+        node& timer = m_nodes[handle];
+        const Uint32 next = timer.next;
+
+        // timers are periodic, they stay in the wheel until removed
+        m_fired.push_back(timer.entity);
+        timer.expiry += timer.period;
+        insert(handle);
+        handle = next;
+    }
+}
+
+void TimerWheel::update(const float dt)
+{
+    for(auto entity : m_fired)
+    {
+        if(m_registry.valid(entity) && m_registry.has<components::timer>(entity))
+        {
+            m_registry.get<components::timer>(entity).fired = false;
+        }
+    }
+    m_fired.clear();
+
+    // timers fire after whole ticks, at least one
+    for(auto entity : m_pending)
+    {
+        auto &timer = m_registry.get<components::timer>(entity);
+        const Uint32 period = std::max(1l, std::lround(timer.period / dt));
+        const Uint64 delay = std::max(1l, std::lround(timer.period * timer.start_offset / dt));
+        timer.handle = add(entity, delay, period);
+    }
+    m_pending.clear();
+
+    advance();
+
+    for(auto entity : m_fired)
+    {
+        m_registry.get<components::timer>(entity).fired = true;
+    }
+}
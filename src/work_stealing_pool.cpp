@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <sciuter/work_stealing_pool.hpp>
+
+// queue of the running thread in the pool that owns it, threads not
+// started by a pool use the first queue
+static thread_local const WorkStealingPool* t_pool = nullptr;
+static thread_local size_t t_queue = 0;
+
+// yields of a waiting thread with nothing to run before it sleeps
+const int WAIT_SPINS = 64;
+
+WorkStealingPool::WorkStealingPool(size_t threads)
+{
+    if(threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for(size_t i = 0; i < threads; ++i)
+    {
+        m_queues.push_back(std::make_unique<task_queue>());
+    }
+    for(size_t i = 1; i < threads; ++i)
+    {
+        m_workers.emplace_back([this, i] { work(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for(auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+size_t WorkStealingPool::current_queue() const
+{
+    return t_pool == this ? t_queue : 0;
+}
+
+void WorkStealingPool::push(std::function<void()> task)
+{
+    task_queue& queue = *m_queues[current_queue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    m_queued.fetch_add(1, std::memory_order_release);
+    {
+        // taken so that a worker can't miss the wake up between its
+        // check of m_queued and going to sleep
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    }
+    m_wake.notify_one();
+}
+
+bool WorkStealingPool::pop(const size_t queue, std::function<void()>& task)
+{
+    task_queue& own = *m_queues[queue];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if(own.tasks.empty())
+    {
+        return false;
+    }
+    task = std::move(own.tasks.back());
+    own.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(const size_t thief, std::function<void()>& task)
+{
+    for(size_t i = 1; i < m_queues.size(); ++i)
+    {
+        task_queue& victim = *m_queues[(thief + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::run_one(const size_t queue)
+{
+    std::function<void()> task;
+    if(!pop(queue, task) && !steal(queue, task))
+    {
+        return false;
+    }
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+}
+
+void WorkStealingPool::work(const size_t queue)
+{
+    t_pool = this;
+    t_queue = queue;
+
+    for(;;)
+    {
+        if(run_one(queue))
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_wake.wait(lock, [this] {
+            return m_stopping || m_queued.load(std::memory_order_acquire) > 0;
+        });
+        if(m_stopping)
+        {
+            return;
+        }
+    }
+}
+
+void WorkStealingPool::wait(const std::atomic<int>& remaining)
+{
+    const size_t queue = current_queue();
+    int idle = 0;
+
+    for(;;)
+    {
+        const int left = remaining.load(std::memory_order_acquire);
+        if(left <= 0)
+        {
+            return;
+        }
+        if(run_one(queue))
+        {
+            idle = 0;
+            continue;
+        }
+
+        // the last tasks are running on other threads: they are short,
+        // but spinning on a busy core keeps them from finishing
+        if(++idle < WAIT_SPINS)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            remaining.wait(left, std::memory_order_acquire);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * sciuter_animations: converts a TexturePacker json to a precompiled
+ * animation table (see BinaryAnimationLoader):
+ *
+ * $ sciuter_animations resources/images/ufo.json ufo.anim
+ *
+ * sciuter_pack already converts the animations it bundles, this is for
+ * inspecting or shipping single tables.
+ */
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <vector>
+#include <sciuter/animation.hpp>
+
+int main(int argc, char* argv[])
+{
+    if(argc != 3)
+    {
+        fprintf(stderr, "usage: %s input.json output\n", argv[0]);
+        return 1;
+    }
+
+    AnimationMap animations;
+    try
+    {
+        animations = TexturePackerAnimationLoader::load(std::string(argv[1]));
+    }
+    catch(const std::exception& e)
+    {
+        fprintf(stderr, "%s: %s\n", argv[1], e.what());
+        return 1;
+    }
+
+    const std::vector<char> table = BinaryAnimationLoader::write(animations);
+
+    std::ofstream output(argv[2], std::ios::binary);
+    output.write(table.data(), table.size());
+    if(!output)
+    {
+        fprintf(stderr, "Unable to write %s\n", argv[2]);
+        return 1;
+    }
+
+    size_t frames = 0;
+    for(const auto& [name, animation] : animations)
+    {
+        frames += animation.get_frame_count();
+    }
+    printf("%zu animations, %zu frames, %zu bytes\n",
+           animations.size(), frames, table.size());
+    return 0;
+}
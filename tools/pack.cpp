@@ -0,0 +1,182 @@
+/**
+ * sciuter_pack: bundles the assets listed in a manifest into a single
+ * asset pack (see asset_pack.hpp), run it from the project root:
+ *
+ * $ sciuter_pack resources/assets.txt resources/assets.pak
+ *
+ * TexturePacker animation json are converted to precompiled animation
+ * tables, so the game loads them without parsing.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <entt/entt.hpp>
+#include <sciuter/animation.hpp>
+#include <sciuter/asset_pack.hpp>
+
+struct packed_asset
+{
+    pack_entry entry;
+    std::string name;
+    std::vector<char> data;
+};
+
+bool read_file(const std::string& path, std::vector<char>& data)
+{
+    std::ifstream input(path, std::ios::binary);
+    if(!input)
+    {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(input),
+                std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool read_manifest(const std::string& path, std::vector<packed_asset>& assets)
+{
+    std::ifstream input(path);
+    if(!input)
+    {
+        fprintf(stderr, "Unable to open manifest %s\n", path.c_str());
+        return false;
+    }
+
+    std::string line;
+    int line_number = 0;
+    while(std::getline(input, line))
+    {
+        ++line_number;
+        if(line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string name, type, file;
+        if(!(fields >> name >> type >> file))
+        {
+            fprintf(stderr, "%s:%d: expected name type path\n",
+                    path.c_str(), line_number);
+            return false;
+        }
+
+        packed_asset asset;
+        asset.name = name;
+        asset.entry.id = entt::hashed_string::to_value(name.c_str());
+        if(type == "image")
+        {
+            asset.entry.type = asset_type::image;
+        }
+        else if(type == "animations")
+        {
+            asset.entry.type = asset_type::animations;
+        }
+        else
+        {
+            fprintf(stderr, "%s:%d: unknown asset type %s\n",
+                    path.c_str(), line_number, type.c_str());
+            return false;
+        }
+
+        if(!read_file(file, asset.data))
+        {
+            fprintf(stderr, "%s:%d: unable to read %s\n",
+                    path.c_str(), line_number, file.c_str());
+            return false;
+        }
+
+        if(asset.entry.type == asset_type::animations)
+        {
+            try
+            {
+                asset.data = BinaryAnimationLoader::write(
+                    TexturePackerAnimationLoader::load(asset.data.data(),
+                                                       asset.data.size()));
+            }
+            catch(const std::exception& e)
+            {
+                fprintf(stderr, "%s: %s\n", file.c_str(), e.what());
+                return false;
+            }
+        }
+        assets.push_back(std::move(asset));
+    }
+    return true;
+}
+
+bool write_pack(const std::string& path, std::vector<packed_asset>& assets)
+{
+    // the runtime looks entries up with a binary search
+    std::sort(assets.begin(), assets.end(),
+              [](const packed_asset& a, const packed_asset& b) {
+                  return a.entry.id < b.entry.id;
+              });
+
+    for(size_t i = 1; i < assets.size(); ++i)
+    {
+        if(assets[i - 1].entry.id == assets[i].entry.id)
+        {
+            fprintf(stderr, "Assets %s and %s have the same id\n",
+                    assets[i - 1].name.c_str(), assets[i].name.c_str());
+            return false;
+        }
+    }
+
+    pack_header header = {};
+    memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = PACK_VERSION;
+    header.entry_count = assets.size();
+
+    Uint64 offset = sizeof(header) + assets.size() * sizeof(pack_entry);
+    for(auto& asset : assets)
+    {
+        offset = (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+        asset.entry.offset = offset;
+        asset.entry.size = asset.data.size();
+        offset += asset.data.size();
+    }
+
+    std::ofstream output(path, std::ios::binary);
+    if(!output)
+    {
+        fprintf(stderr, "Unable to write %s\n", path.c_str());
+        return false;
+    }
+
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for(const auto& asset : assets)
+    {
+        output.write(reinterpret_cast<const char*>(&asset.entry),
+                     sizeof(asset.entry));
+    }
+    for(const auto& asset : assets)
+    {
+        const std::vector<char> padding(asset.entry.offset - output.tellp(), 0);
+        output.write(padding.data(), padding.size());
+        output.write(asset.data.data(), asset.data.size());
+    }
+    return (bool)output;
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc != 3)
+    {
+        fprintf(stderr, "usage: %s manifest output\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<packed_asset> assets;
+    if(!read_manifest(argv[1], assets) || !write_pack(argv[2], assets))
+    {
+        return 1;
+    }
+
+    printf("Packed %zu assets into %s\n", assets.size(), argv[2]);
+    return 0;
+}